@@ -0,0 +1,5 @@
+#include "AudioContext.h"
+
+AudioContext::AudioContext(double frames_per_second_input)
+    : frames_per_second(frames_per_second_input),
+      envelope_tables(frames_per_second_input) {}
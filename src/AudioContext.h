@@ -0,0 +1,14 @@
+#pragma once
+
+#include "EnvelopeTables.h"
+
+// everything that depends on the sample rate, owned by one engine
+// nothing is shared between rates, so engines at different rates
+// can render side by side, on different threads
+class AudioContext {
+ public:
+  const double frames_per_second;
+  const EnvelopeTables envelope_tables;
+
+  explicit AudioContext(double frames_per_second_input);
+};
@@ -5,6 +5,32 @@
 const auto CHORD_COLUMNS = 8;
 const auto CHORD_LEVEL = 1;
 
+constexpr ColumnTable CHORD_COLUMN_TABLE = {
+    ColumnDescriptor{
+        nullptr, false,
+        [](const NoteChord & /*note_chord*/) -> QVariant { return "♫"; },
+        nullptr},
+    NUMERATOR_DESCRIPTOR,
+    DENOMINATOR_DESCRIPTOR,
+    OCTAVE_DESCRIPTOR,
+    // chords can go back in time
+    ColumnDescriptor{
+        "beats", true,
+        [](const NoteChord &note_chord) -> QVariant { return note_chord.beats; },
+        [](NoteChord &note_chord, const QVariant &value) {
+          note_chord.beats = value.toInt();
+          return true;
+        }},
+    VOLUME_RATIO_DESCRIPTOR,
+    TEMPO_RATIO_DESCRIPTOR,
+    WORDS_DESCRIPTOR,
+    // need to return empty even if its inaccessible
+    ColumnDescriptor{
+        nullptr, false,
+        [](const NoteChord & /*note_chord*/) -> QVariant { return {}; },
+        nullptr},
+};
+
 // TODO: removeRows data from root?
 class Chord : public NoteChord {
  public:
@@ -13,12 +39,10 @@ class Chord : public NoteChord {
   [[nodiscard]] auto get_level() const -> int override;
   [[nodiscard]] auto columnCount() const -> int override;
 
-  [[nodiscard]] auto flags(int column, Qt::ItemFlags default_flags) const
-      -> Qt::ItemFlags override;
-  [[nodiscard]] auto data(int column, int role) const -> QVariant override;
-  auto setData(int column, const QVariant &value, int role) -> bool override;
   void test() override;
-  auto pointer_copy_self() -> std::unique_ptr<NoteChord> override;
-  auto new_child_note_chord_pointer() -> std::unique_ptr<NoteChord> override;
+  [[nodiscard]] auto pointer_copy_self(NodeArena *arena_pointer) const
+      -> std::shared_ptr<NoteChord> override;
+  [[nodiscard]] auto new_child_note_chord_pointer(
+      NodeArena *arena_pointer) const -> std::shared_ptr<NoteChord> override;
 
 };
@@ -0,0 +1,65 @@
+#include "ChordAudioCache.h"
+
+void ChordKey::clear() {
+  instrument_ids.clear();
+  frequencies.clear();
+  amplitudes.clear();
+  end_frames.clear();
+}
+
+auto ChordKey::get_hash() const -> uint64_t {
+  auto hash = add_to_hash(HASH_START, frames_per_second);
+  for (size_t note = 0; note < instrument_ids.size(); note = note + 1) {
+    hash = add_to_hash(hash, instrument_ids[note]);
+    hash = add_to_hash(hash, frequencies[note]);
+    hash = add_to_hash(hash, amplitudes[note]);
+    hash = add_to_hash(hash, end_frames[note]);
+  }
+  return hash;
+}
+
+// only with the lock held
+auto ChordAudioCache::find(const ChordKey &key, uint64_t hash)
+    -> decltype(entry_iterators)::iterator {
+  auto [found, end_found] = entry_iterators.equal_range(hash);
+  while (found != end_found && !(found->second->first == key)) {
+    found = std::next(found);
+  }
+  return found == end_found ? entry_iterators.end() : found;
+}
+
+auto ChordAudioCache::get(const ChordKey &key) -> ChordAudio {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto found = find(key, key.get_hash());
+  if (found == entry_iterators.end()) {
+    return nullptr;
+  }
+  // move to the front
+  entries.splice(entries.begin(), entries, found->second);
+  return found->second->second;
+}
+
+void ChordAudioCache::add(const ChordKey &key, const ChordAudio &chord_audio) {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto hash = key.get_hash();
+  if (find(key, hash) != entry_iterators.end()) {
+    return;
+  }
+  entries.emplace_front(key, chord_audio);
+  entry_iterators.emplace(hash, entries.begin());
+  cached_samples = cached_samples + chord_audio->size();
+  // engines hold their own pointers, so evicting never frees audio in use
+  while (cached_samples > max_samples && entries.size() > 1) {
+    const auto &[old_key, old_audio] = entries.back();
+    cached_samples = cached_samples - old_audio->size();
+    entry_iterators.erase(find(old_key, old_key.get_hash()));
+    entries.pop_back();
+  }
+}
+
+void ChordAudioCache::clear() {
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  entries.clear();
+  entry_iterators.clear();
+  cached_samples = 0;
+}
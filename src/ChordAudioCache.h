@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// about 3 minutes of mono audio at 48 kHz
+const auto CHORD_CACHE_SAMPLES = static_cast<size_t>(1) << 23;
+const auto HASH_START = static_cast<uint64_t>(14695981039346656037ULL);
+const auto HASH_PRIME = static_cast<uint64_t>(1099511628211ULL);
+
+using ChordAudio = std::shared_ptr<const std::vector<float>>;
+
+// fnv-1a, so equal notes always give equal keys
+template <typename Value>
+auto add_to_hash(uint64_t hash, const Value &value) -> uint64_t {
+  const auto *byte_pointer = reinterpret_cast<const unsigned char *>(&value);
+  for (size_t byte = 0; byte < sizeof(Value); byte = byte + 1) {
+    hash = (hash ^ byte_pointer[byte]) * HASH_PRIME;
+  }
+  return hash;
+}
+
+// everything that determines a chord's audio
+// hashes can collide, so we compare the whole key too
+class ChordKey {
+ public:
+  double frames_per_second = 0.0;
+  std::vector<int> instrument_ids;
+  std::vector<float> frequencies;
+  std::vector<float> amplitudes;
+  // from the start of the chord
+  std::vector<int64_t> end_frames;
+
+  void clear();
+  [[nodiscard]] auto get_hash() const -> uint64_t;
+  [[nodiscard]] auto operator==(const ChordKey &other) const -> bool = default;
+};
+
+// mono audio of chords we've already rendered, keyed by everything that
+// determines them, so we only render chords that changed
+// least recently used chords go first, when we run out of room
+// locked, because engines on different threads can share it
+// the audio thread never touches it
+class ChordAudioCache {
+ public:
+  std::mutex cache_mutex;
+  size_t max_samples = CHORD_CACHE_SAMPLES;
+  size_t cached_samples = 0;
+  // most recently used first
+  std::list<std::pair<ChordKey, ChordAudio>> entries;
+  // keyed by hash, so chords with the same hash share a bucket
+  std::unordered_multimap<
+      uint64_t, std::list<std::pair<ChordKey, ChordAudio>>::iterator>
+      entry_iterators;
+
+  // null if we haven't rendered it
+  [[nodiscard]] auto get(const ChordKey &key) -> ChordAudio;
+  void add(const ChordKey &key, const ChordAudio &chord_audio);
+  void clear();
+  [[nodiscard]] auto find(const ChordKey &key, uint64_t hash)
+      -> decltype(entry_iterators)::iterator;
+};
@@ -0,0 +1,69 @@
+#include "ChordStateTree.h"
+
+ChordTransform::ChordTransform(const CompiledChord &compiled_chord)
+    : key_ratio(compiled_chord.key_ratio),
+      volume_ratio(compiled_chord.volume_ratio),
+      tempo_ratio(compiled_chord.tempo_ratio),
+      // chords modulate before they play, so their beats are at the new tempo
+      beats(static_cast<double>(compiled_chord.beats) / compiled_chord.tempo_ratio) {}
+
+auto ChordTransform::then(const ChordTransform &next) const -> ChordTransform {
+  ChordTransform result;
+  result.key_ratio = key_ratio * next.key_ratio;
+  result.volume_ratio = volume_ratio * next.volume_ratio;
+  result.tempo_ratio = tempo_ratio * next.tempo_ratio;
+  // the next run starts at our tempo
+  result.beats = beats + next.beats / tempo_ratio;
+  return result;
+}
+
+void ChordStateTree::resize(int chord_count) {
+  leaf_count = 1;
+  while (leaf_count < chord_count) {
+    leaf_count = leaf_count * 2;
+  }
+  nodes.assign(2 * leaf_count, ChordTransform());
+}
+
+void ChordStateTree::set_leaf(int chord_position,
+                              const ChordTransform &transform) {
+  nodes[leaf_count + chord_position] = transform;
+}
+
+void ChordStateTree::build() {
+  for (auto node = leaf_count - 1; node > 0; node = node - 1) {
+    nodes[node] = nodes[2 * node].then(nodes[2 * node + 1]);
+  }
+}
+
+void ChordStateTree::update(int chord_position,
+                            const ChordTransform &transform) {
+  auto node = leaf_count + chord_position;
+  nodes[node] = transform;
+  node = node / 2;
+  while (node > 0) {
+    nodes[node] = nodes[2 * node].then(nodes[2 * node + 1]);
+    node = node / 2;
+  }
+}
+
+auto ChordStateTree::get_prefix(int end_position) const -> ChordTransform {
+  // transforms don't commute, so collect the left and right sides apart
+  ChordTransform left;
+  ChordTransform right;
+  auto low = leaf_count;
+  auto high = leaf_count + end_position;
+  while (low < high) {
+    if (low % 2 == 1) {
+      left = left.then(nodes[low]);
+      low = low + 1;
+    }
+    if (high % 2 == 1) {
+      high = high - 1;
+      right = nodes[high].then(right);
+    }
+    low = low / 2;
+    high = high / 2;
+  }
+  return left.then(right);
+}
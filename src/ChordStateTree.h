@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include "CompiledChord.h"
+
+// what a run of chords does to the key, volume, tempo and time
+class ChordTransform {
+ public:
+  double key_ratio = 1.0;
+  double volume_ratio = 1.0;
+  double tempo_ratio = 1.0;
+  // how long the run lasts, in beats at the tempo going in
+  double beats = 0.0;
+
+  ChordTransform() = default;
+  explicit ChordTransform(const CompiledChord &compiled_chord);
+  // this run, then the next one
+  [[nodiscard]] auto then(const ChordTransform &next) const -> ChordTransform;
+};
+
+// a segment tree of chord transforms, so we can find the state
+// before any chord in O(log n), and update one chord in O(log n)
+class ChordStateTree {
+ public:
+  // a power of 2, leaves start here
+  int leaf_count = 1;
+  // 1 is the root, the children of node are 2 node and 2 node + 1
+  std::vector<ChordTransform> nodes = std::vector<ChordTransform>(2);
+
+  // sets everything to identity
+  void resize(int chord_count);
+  // doesn't update parents, call build after
+  void set_leaf(int chord_position, const ChordTransform &transform);
+  void build();
+  void update(int chord_position, const ChordTransform &transform);
+  // the transform of chords before end_position
+  [[nodiscard]] auto get_prefix(int end_position) const -> ChordTransform;
+};
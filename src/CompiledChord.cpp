@@ -0,0 +1,30 @@
+#include "CompiledChord.h"
+
+#include "InstrumentRegistry.h"
+
+void CompiledChord::compile(const TreeNode &chord_node) {
+  const auto &chord_pointer = chord_node.note_chord_pointer;
+  key_ratio = chord_pointer->get_ratio();
+  volume_ratio = chord_pointer->volume_ratio;
+  tempo_ratio = chord_pointer->tempo_ratio;
+  beats = static_cast<float>(chord_pointer->beats);
+  note_key_ratios.clear();
+  note_volume_ratios.clear();
+  note_beats.clear();
+  note_instrument_ids.clear();
+  auto &registry = InstrumentRegistry::get_registry();
+  // before resolving, so a factory registered meanwhile compiles us again
+  factory_generation = registry.factory_generation.load();
+  for (const auto &note_node_pointer : chord_node.child_pointers) {
+    const auto &note_pointer = note_node_pointer->note_chord_pointer;
+    note_key_ratios.push_back(note_pointer->get_ratio());
+    note_volume_ratios.push_back(note_pointer->volume_ratio);
+    note_beats.push_back(static_cast<float>(note_pointer->beats));
+    note_instrument_ids.push_back(registry.resolve(note_pointer->instrument_id));
+  }
+  compiled = true;
+}
+
+auto CompiledChord::get_note_count() const -> int {
+  return static_cast<int>(note_key_ratios.size());
+}
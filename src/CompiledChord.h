@@ -0,0 +1,25 @@
+#pragma once
+
+#include "TreeNode.h"
+
+// a chord's own ratios and its notes, with powers already taken
+// notes are relative to the chord, so editing one chord doesn't
+// invalidate any other
+class CompiledChord {
+ public:
+  bool compiled = false;
+  // the registry's, when we resolved instruments
+  int factory_generation = 0;
+  float key_ratio = 1.0F;
+  float volume_ratio = DEFAULT_VOLUME_RATIO;
+  float tempo_ratio = DEFAULT_TEMPO_RATIO;
+  float beats = DEFAULT_BEATS;
+  std::vector<float> note_key_ratios;
+  std::vector<float> note_volume_ratios;
+  std::vector<float> note_beats;
+  // resolved, so they always have an instrument
+  std::vector<int> note_instrument_ids;
+
+  void compile(const TreeNode &chord_node);
+  [[nodiscard]] auto get_note_count() const -> int;
+};
@@ -1,31 +1,49 @@
 #include "DefaultInstrument.h"
 
-DefaultInstrument::DefaultInstrument(double start_time, float frequency_input,
-                         float amplitude, float duration) : Instrument(),
-      frequency(frequency_input) {
-  if (duration < MIN_DURATION) {
-    qCritical("Too short!");
-  }
-  dt(start_time);
-  auto sustain_level = amplitude * SUSTAIN_RATIO;
-  envelope.lengths(ATTACK_TIME, DECAY_TIME, duration - MIN_DURATION, RELEASE_TIME);
-  envelope.levels(0, amplitude, sustain_level, sustain_level, 0);
-  envelope.curve(CURVATURE);
-}
+#include "Wavetable.h"
 
-auto DefaultInstrument::get_sample() -> float {
-  return oscillator() * envelope();
+DefaultInstrument::DefaultInstrument(const AudioContext &context_input)
+    : Instrument(),
+      context(context_input),
+      frames_per_second(context_input.frames_per_second),
+      table_pointer(WavetableBank::get_bank().tables[0].data()),
+      envelope(context_input.envelope_tables) {}
+
+auto DefaultInstrument::new_voice_pointer() const
+    -> std::unique_ptr<Instrument> {
+  return std::make_unique<DefaultInstrument>(context);
 }
 
-auto DefaultInstrument::add(gam::Scheduler &scheduler, float start_time, float frequency, float amplitude, float duration) const -> float {
+auto DefaultInstrument::get_true_duration(float duration) const -> float {
   if (duration < MIN_DURATION) {
-    duration = MIN_DURATION;
+    return MIN_DURATION;
   }
-  scheduler.add<DefaultInstrument>(start_time, frequency, amplitude, duration);
   return duration;
 }
 
+void DefaultInstrument::start(float frequency, float amplitude,
+                              float duration) {
+  if (duration < MIN_DURATION) {
+    qCritical("Too short!");
+  }
+  table_pointer =
+      WavetableBank::get_bank().get_table(frequency, frames_per_second);
+  phase = 0;
+  phase_increment =
+      WavetableBank::get_phase_increment(frequency, frames_per_second);
+  envelope.start(amplitude, duration - MIN_DURATION);
+}
+
+void DefaultInstrument::render(float *destination, int frames) {
+  WavetableBank::render(table_pointer, phase, phase_increment, destination,
+                        frames);
+  envelope.apply(destination, frames);
+}
+
 auto DefaultInstrument::done() -> bool {
   return envelope.done();
 }
 
+auto DefaultInstrument::get_level() -> float {
+  return envelope.get_level();
+}
@@ -2,6 +2,7 @@
 
 #include <QtGlobal>
 
+#include "AudioContext.h"
 #include "Instrument.h"
 
 const auto FREQUENCY_RATIO = 1;
@@ -9,23 +10,24 @@ const auto AMPLITUDE_RATIO = 0.4F;
 const auto HARMONICS = 8;
 const auto OVERLAP = 0.1F;
 
-const auto ATTACK_TIME = 0.05F;
-const auto DECAY_TIME = 0.2F;
-const auto RELEASE_TIME = 0.1F;
-const auto SUSTAIN_RATIO = 0.6F;
-const auto CURVATURE = -4;
 const auto MIN_SUSTAIN = 0.01F;
 const auto MIN_DURATION = ATTACK_TIME + DECAY_TIME + MIN_SUSTAIN + RELEASE_TIME - OVERLAP;
 
 class DefaultInstrument : public Instrument {
  public:
-  DefaultInstrument(double start_time, float frequency, float amplitude,
-               float duration);
-  const float frequency;
-  gam::DSF<> oscillator = gam::DSF<>(frequency, FREQUENCY_RATIO, AMPLITUDE_RATIO, HARMONICS);
-  gam::Env<4> envelope;
-  auto get_sample() -> float override;
-  auto add(gam::Scheduler &scheduler, float start_time, float frequency, float amplitude, float duration) const -> float override;
+  const AudioContext &context;
+  const double frames_per_second;
+  const float *table_pointer = nullptr;
+  uint32_t phase = 0;
+  uint32_t phase_increment = 0;
+  TableEnvelope envelope;
+
+  explicit DefaultInstrument(const AudioContext &context_input);
+  [[nodiscard]] auto new_voice_pointer() const
+      -> std::unique_ptr<Instrument> override;
+  [[nodiscard]] auto get_true_duration(float duration) const -> float override;
+  void start(float frequency, float amplitude, float duration) override;
+  void render(float *destination, int frames) override;
   auto done() -> bool override;
+  auto get_level() -> float override;
 };
-
@@ -4,6 +4,12 @@ Editor::Editor(QWidget *parent, Qt::WindowFlags flags)
     : QMainWindow(parent, flags) {
   connect(&song, &Song::set_data_signal, this, &Editor::setData);
 
+  play_state.moveToThread(&engine_thread);
+  connect(&play_state, &Player::progress, this, &Editor::show_progress);
+  connect(&play_state, &Player::finished, this, &Editor::show_finished);
+  connect(&play_state, &Player::render_finished, this, &Editor::show_rendered);
+  engine_thread.start();
+
   (*menuBar()).addAction(menu_tab.menuAction());
 
   central_box.setLayout(&central_column);
@@ -21,6 +27,7 @@ Editor::Editor(QWidget *parent, Qt::WindowFlags flags)
 
   volume_percent_slider.setRange(MIN_VOLUME_PERCENT, MAX_VOLUME_PERCENT);
   connect(&volume_percent_slider, &QAbstractSlider::valueChanged, this, &Editor::set_volume_percent_label);
+  connect(&volume_percent_slider, &QAbstractSlider::valueChanged, this, &Editor::send_volume_percent);
   connect(&volume_percent_slider, &QAbstractSlider::sliderReleased, this, &Editor::create_volume_percent_change);
   connect(&song, &Song::volume_changed, &volume_percent_slider, &QSlider::setValue);
   volume_percent_slider.setValue(song.volume_percent);
@@ -28,6 +35,7 @@ Editor::Editor(QWidget *parent, Qt::WindowFlags flags)
 
   tempo_slider.setRange(MIN_TEMPO, MAX_TEMPO);
   connect(&tempo_slider, &QAbstractSlider::valueChanged, this, &Editor::set_tempo_label);
+  connect(&tempo_slider, &QAbstractSlider::valueChanged, this, &Editor::send_tempo);
   connect(&tempo_slider, &QAbstractSlider::sliderReleased, this, &Editor::create_tempo_change);
   connect(&song, &Song::tempo_changed, &tempo_slider, &QSlider::setValue);
   tempo_slider.setValue(song.tempo);
@@ -70,6 +78,63 @@ Editor::Editor(QWidget *parent, Qt::WindowFlags flags)
   connect(&play_action, &QAction::triggered, this, &Editor::play);
   play_action.setShortcuts(QKeySequence::Print);
 
+  play_from_here_action.setEnabled(false);
+  menu_tab.addAction(&play_from_here_action);
+  connect(&play_from_here_action, &QAction::triggered, this,
+          &Editor::play_from_here);
+
+  stop_action.setEnabled(false);
+  menu_tab.addAction(&stop_action);
+  connect(&stop_action, &QAction::triggered, this, &Editor::stop_playing);
+
+  render_action.setEnabled(false);
+  menu_tab.addAction(&render_action);
+  connect(&render_action, &QAction::triggered, this, &Editor::render);
+
+  menu_tab.addAction(&save_stats_action);
+  connect(&save_stats_action, &QAction::triggered, this, &Editor::save_stats);
+
+  keep_stream_open_action.setCheckable(true);
+  menu_tab.addAction(&keep_stream_open_action);
+  connect(&keep_stream_open_action, &QAction::toggled, this,
+          &Editor::set_keep_stream_open);
+
+  cache_chords_action.setCheckable(true);
+  menu_tab.addAction(&cache_chords_action);
+  connect(&cache_chords_action, &QAction::toggled, this,
+          &Editor::set_cache_chords);
+
+  menu_tab.addAction(latency_menu.menuAction());
+  const auto latency_names =
+      std::array<QString, 4>({tr("Low Latency"), tr("Balanced"), tr("Safe"),
+                              tr("Automatic")});
+  for (auto profile = 0; profile < static_cast<int>(latency_names.size());
+       profile = profile + 1) {
+    auto &action = *latency_menu.addAction(latency_names[profile]);
+    action.setCheckable(true);
+    action.setChecked(profile == play_state.latency_profile);
+    action.setData(profile);
+    latency_group.addAction(&action);
+  }
+  connect(&latency_group, &QActionGroup::triggered, this,
+          &Editor::set_latency_profile);
+
+  menu_tab.addAction(sample_rate_menu.menuAction());
+  for (auto sample_rate : SAMPLE_RATES) {
+    auto &action = *sample_rate_menu.addAction(
+        sample_rate == 0 ? tr("Device Default") : tr("%1 Hz").arg(sample_rate));
+    action.setCheckable(true);
+    action.setChecked(sample_rate == 0);
+    action.setData(sample_rate);
+    sample_rate_group.addAction(&action);
+  }
+  connect(&sample_rate_group, &QActionGroup::triggered, this,
+          &Editor::set_frames_per_second);
+
+  menu_tab.addAction(mute_menu.menuAction());
+  connect(&mute_menu, &QMenu::aboutToShow, this, &Editor::update_mute_menu);
+  connect(&mute_menu, &QMenu::triggered, this, &Editor::send_muted);
+
   auto &undo_action = *undo_stack.createUndoAction(this, tr("&Undo"));
   undo_action.setShortcuts(QKeySequence::Undo);
   menu_tab.addAction(&undo_action);
@@ -111,6 +176,12 @@ Editor::Editor(QWidget *parent, Qt::WindowFlags flags)
 }
 
 Editor::~Editor() {
+  // stop on the player thread, where the player lives
+  QMetaObject::invokeMethod(
+      &play_state, [this]() { play_state.stop(); },
+      Qt::BlockingQueuedConnection);
+  engine_thread.quit();
+  engine_thread.wait();
   central_box.setParent(nullptr);
   view.setParent(nullptr);
   sliders_box.setParent(nullptr);
@@ -130,10 +201,143 @@ void Editor::copy() {
 void Editor::play() {
   selected = view.selectionModel()->selectedRows();
   if (!(selected.empty())) {
-    play_state.play(song, selected[0], static_cast<int>(selected.size()));
+    // only snapshot here; scheduling and the device are on the player thread
+    played_volume_percent = song.volume_percent;
+    played_tempo = song.tempo;
+    muted_flags.clear();
+    QMetaObject::invokeMethod(
+        &play_state,
+        [this, performance = Performance(song, selected[0],
+                                         static_cast<int>(selected.size()))]() mutable {
+          play_state.play(std::move(performance));
+        },
+        Qt::QueuedConnection);
+    stop_action.setEnabled(true);
+  }
+}
+
+// plays the whole song, seeking to the chord of the first selected row
+void Editor::play_from_here() {
+  selected = view.selectionModel()->selectedRows();
+  if (!(selected.empty())) {
+    const auto &first_index = selected[0];
+    auto chord_position = first_index.parent().isValid()
+                              ? first_index.parent().row()
+                              : first_index.row();
+    // the chord state counts beats at the song tempo
+    auto seconds = static_cast<float>(
+        song.get_chord_state(chord_position).beats * SECONDS_PER_MINUTE /
+        song.tempo);
+    played_volume_percent = song.volume_percent;
+    played_tempo = song.tempo;
+    muted_flags.clear();
+    QMetaObject::invokeMethod(
+        &play_state,
+        [this,
+         performance = Performance(
+             song, song.index(0, 0),
+             static_cast<int>(song.root.get_child_count())),
+         seconds]() mutable {
+          play_state.play(std::move(performance), seconds);
+        },
+        Qt::QueuedConnection);
+    stop_action.setEnabled(true);
+  }
+}
+
+void Editor::stop_playing() {
+  // silence the audio thread now, instead of waiting for the player thread
+  send_control(ControlMessage{stop_control});
+  QMetaObject::invokeMethod(
+      &play_state, [this]() { play_state.stop(); }, Qt::QueuedConnection);
+}
+
+void Editor::show_progress(float seconds) {
+  // the stats are atomic, so we can read them from here
+  const auto &stats = play_state.engine.stats;
+  statusBar()->showMessage(
+      tr("Playing: %1 s, load %2%, %3 xruns, %4 voices")
+          .arg(std::max(seconds, 0.0F), 0, 'f', 1)
+          .arg(qRound(stats.get_load() * PERCENT))
+          .arg(stats.xruns.load())
+          .arg(stats.active_voices.load()));
+}
+
+void Editor::show_finished() {
+  statusBar()->clearMessage();
+  stop_action.setEnabled(false);
+}
+
+void Editor::show_rendered(const QString &file_name, bool succeeded) {
+  if (succeeded) {
+    statusBar()->showMessage(tr("Rendered %1").arg(file_name));
+  } else {
+    statusBar()->showMessage(tr("Cannot render %1").arg(file_name));
+  }
+}
+
+void Editor::render() {
+  selected = view.selectionModel()->selectedRows();
+  if (!(selected.empty())) {
+    auto file_name = QFileDialog::getSaveFileName(
+        this, tr("Render selection"), QString(),
+        tr("Sound files (*.wav *.flac)"));
+    if (!(file_name.isEmpty())) {
+      QMetaObject::invokeMethod(
+          &play_state,
+          [this, performance = Performance(
+                     song, selected[0], static_cast<int>(selected.size())),
+           file_name]() mutable {
+            play_state.start_render(std::move(performance), file_name);
+          },
+          Qt::QueuedConnection);
+      statusBar()->showMessage(tr("Rendering %1").arg(file_name));
+    }
   }
 }
 
+void Editor::save_stats() {
+  auto file_name = QFileDialog::getSaveFileName(
+      this, tr("Save audio statistics"), QString(), tr("JSON files (*.json)"));
+  if (!(file_name.isEmpty()) && !(play_state.engine.stats.save(file_name))) {
+    qCritical("Cannot write to %s!", qUtf8Printable(file_name));
+  }
+}
+
+void Editor::set_keep_stream_open(bool keep_stream_open) {
+  QMetaObject::invokeMethod(
+      &play_state,
+      [this, keep_stream_open]() {
+        play_state.set_keep_stream_open(keep_stream_open);
+      },
+      Qt::QueuedConnection);
+}
+
+void Editor::set_cache_chords(bool cache_chords) {
+  QMetaObject::invokeMethod(
+      &play_state,
+      [this, cache_chords]() { play_state.set_cache_chords(cache_chords); },
+      Qt::QueuedConnection);
+}
+
+void Editor::set_latency_profile(QAction *action_pointer) {
+  auto latency_profile = static_cast<LatencyProfile>(action_pointer->data().toInt());
+  QMetaObject::invokeMethod(
+      &play_state,
+      [this, latency_profile]() { play_state.set_latency_profile(latency_profile); },
+      Qt::QueuedConnection);
+}
+
+void Editor::set_frames_per_second(QAction *action_pointer) {
+  auto frames_per_second = action_pointer->data().toDouble();
+  QMetaObject::invokeMethod(
+      &play_state,
+      [this, frames_per_second]() {
+        play_state.set_frames_per_second(frames_per_second);
+      },
+      Qt::QueuedConnection);
+}
+
 void Editor::error_empty() { qCritical("Empty selected"); }
 
 auto Editor::first_selected_index() -> QModelIndex {
@@ -231,6 +435,8 @@ void Editor::reenable_actions() {
   }
 
   play_action.setEnabled(group_selected);
+  play_from_here_action.setEnabled(group_selected);
+  render_action.setEnabled(group_selected);
   insert_before_action.setEnabled(group_selected);
   insert_after_action.setEnabled(group_selected);
   remove_action.setEnabled(group_selected);
@@ -256,6 +462,55 @@ auto Editor::create_tempo_change() -> void {
   undo_stack.push(new TempoChange(song, song.tempo, tempo_slider.value()));
 }
 
+// the gui thread is the only one that sends control messages
+// if the queue is full, we drop the message; the next change catches up
+// stamped, so the audio thread drops it once we play something else
+void Editor::send_control(ControlMessage message) {
+  if (stop_action.isEnabled()) {
+    message.generation = play_state.engine.generation.load();
+    play_state.engine.control_queue.push(message);
+  }
+}
+
+void Editor::send_volume_percent(int value) {
+  if (played_volume_percent > 0) {
+    send_control(ControlMessage{master_gain_control,
+                                (1.0 * value) / played_volume_percent});
+  }
+}
+
+void Editor::send_tempo(int value) {
+  send_control(ControlMessage{tempo_scale_control, (1.0 * value) / played_tempo});
+}
+
+// instruments come and go, so list them each time
+// we can only mute what's playing
+void Editor::update_mute_menu() {
+  mute_menu.clear();
+  auto &registry = InstrumentRegistry::get_registry();
+  auto instrument_count = registry.get_instrument_count();
+  muted_flags.resize(instrument_count, false);
+  for (auto instrument_id = 0; instrument_id < instrument_count;
+       instrument_id = instrument_id + 1) {
+    // names without an instrument play as another one
+    if (registry.resolve(instrument_id) == instrument_id) {
+      auto &action = *mute_menu.addAction(registry.get_name(instrument_id));
+      action.setCheckable(true);
+      action.setChecked(muted_flags[instrument_id]);
+      action.setEnabled(stop_action.isEnabled());
+      action.setData(instrument_id);
+    }
+  }
+}
+
+void Editor::send_muted(QAction *action_pointer) {
+  auto instrument_id = action_pointer->data().toInt();
+  auto muted = action_pointer->isChecked();
+  muted_flags[instrument_id] = muted;
+  send_control(ControlMessage{muted ? mute_control : unmute_control, 0.0,
+                              instrument_id});
+}
+
 auto Editor::set_frequency_label(int value) -> void {
   frequency_label.setText(tr("Starting frequency: %1 Hz").arg(value));
 }
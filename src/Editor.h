@@ -1,8 +1,10 @@
 #pragma once
 
+#include <QActionGroup>
 #include <QByteArray>
 #include <QClipboard>
 #include <QFile>
+#include <QFileDialog>
 #include <QFormLayout>
 #include <QGuiApplication>
 #include <QHeaderView>
@@ -12,6 +14,8 @@
 #include <QMenuBar>
 #include <QMimeData>
 #include <QMenu>
+#include <QStatusBar>
+#include <QThread>
 #include <QTreeView>
 #include <QUndoStack>
 #include <QVBoxLayout>
@@ -27,6 +31,8 @@ const auto MIN_VOLUME_PERCENT = 0;
 const auto MAX_VOLUME_PERCENT = 100;
 const auto MIN_TEMPO = 100;
 const auto MAX_TEMPO = 800;
+// 0 for the device default
+const auto SAMPLE_RATES = std::array<int, 4>({0, 44100, 48000, 96000});
 
 enum Relationship {
   selection_first,
@@ -38,6 +44,8 @@ class Editor : public QMainWindow {
   Q_OBJECT
  public:
   // TODO: make const?
+  // declared before undo_stack and copied, so it's destroyed after them
+  // their nodes go back to the song's arena when they're freed
   Song song;
 
   QWidget central_box;
@@ -50,6 +58,11 @@ class Editor : public QMainWindow {
   QMenu menu_tab = QMenu(tr("&Menu"));
   QMenu insert_menu = QMenu(tr("&Insert"));
   QMenu paste_menu = QMenu(tr("&Paste"));
+  QMenu latency_menu = QMenu(tr("&Latency"));
+  QMenu sample_rate_menu = QMenu(tr("&Sample Rate"));
+  QMenu mute_menu = QMenu(tr("&Mute Instrument"));
+  QActionGroup latency_group = QActionGroup(this);
+  QActionGroup sample_rate_group = QActionGroup(this);
 
   QAction copy_action = QAction(tr("Copy"));
   QAction paste_before_action = QAction(tr("Before"));
@@ -62,6 +75,12 @@ class Editor : public QMainWindow {
   QAction remove_action = QAction(tr("&Remove"));
 
   QAction play_action = QAction(tr("Play Selection"));
+  QAction play_from_here_action = QAction(tr("Play From Here"));
+  QAction stop_action = QAction(tr("Stop Playing"));
+  QAction render_action = QAction(tr("Render Selection..."));
+  QAction save_stats_action = QAction(tr("Save Audio Statistics..."));
+  QAction keep_stream_open_action = QAction(tr("Keep Audio Open"));
+  QAction cache_chords_action = QAction(tr("Cache Chord Audio"));
 
   QWidget sliders_box;
   QFormLayout sliders_form;
@@ -73,6 +92,14 @@ class Editor : public QMainWindow {
 
   QUndoStack undo_stack;
 
+  // what we're playing was built with these, so sliders change it relatively
+  int played_volume_percent = DEFAULT_VOLUME_PERCENT;
+  int played_tempo = DEFAULT_TEMPO;
+  // by instrument id, for what we're playing
+  std::vector<bool> muted_flags;
+
+  // playback runs here so it never blocks the event loop
+  QThread engine_thread;
   Player play_state;
 
   QModelIndexList selected;
@@ -95,6 +122,11 @@ class Editor : public QMainWindow {
   auto set_frequency_label(int value) -> void;
   auto set_volume_percent_label(int value) -> void;
   auto set_tempo_label(int value) -> void;
+  void send_control(ControlMessage message);
+  void send_volume_percent(int value);
+  void send_tempo(int value);
+  void update_mute_menu();
+  void send_muted(QAction *action_pointer);
 
   void copy();
   static void error_empty();
@@ -114,6 +146,17 @@ class Editor : public QMainWindow {
   void removeRows();
   void save() const;
   void play();
+  void play_from_here();
+  void stop_playing();
+  void show_progress(float seconds);
+  void show_finished();
+  void show_rendered(const QString &file_name, bool succeeded);
+  void render();
+  void save_stats();
+  void set_keep_stream_open(bool keep_stream_open);
+  void set_cache_chords(bool cache_chords);
+  void set_latency_profile(QAction *action_pointer);
+  void set_frames_per_second(QAction *action_pointer);
   auto setData(const QModelIndex& index, const QVariant& value, int role)
       -> bool;
   auto insert(int position, int rows, const QModelIndex& parent_index) -> bool;
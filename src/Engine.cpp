@@ -0,0 +1,568 @@
+#include "Engine.h"
+
+#include <chrono>
+
+Engine::Engine(double frames_per_second_input, int max_polyphony_input,
+               StealingPolicy stealing_policy_input)
+    : frames_per_second(frames_per_second_input),
+      context_pointer(std::make_unique<AudioContext>(frames_per_second_input)),
+      max_polyphony(max_polyphony_input),
+      stealing_policy(stealing_policy_input) {
+  make_voice_pools();
+}
+
+// instruments depend on the sample rate, so make them all again
+void Engine::make_voice_pools() {
+  voice_pool_pointers.clear();
+  auto &registry = InstrumentRegistry::get_registry();
+  auto instrument_count = registry.get_instrument_count();
+  for (auto instrument_id = 0; instrument_id < instrument_count;
+       instrument_id = instrument_id + 1) {
+    auto prototype_pointer =
+        registry.new_prototype_pointer(instrument_id, *context_pointer);
+    if (prototype_pointer == nullptr) {
+      voice_pool_pointers.push_back(nullptr);
+    } else {
+      voice_pool_pointers.push_back(std::make_unique<VoicePool>(
+          *prototype_pointer, max_polyphony, stealing_policy));
+    }
+  }
+  reserve_active_voices();
+}
+
+// allocates, so only call this while stopped
+void Engine::set_frames_per_second(double new_frames_per_second) {
+  if (new_frames_per_second != frames_per_second) {
+    clear();
+    // voices point into the context, so they go first
+    voice_pool_pointers.clear();
+    frames_per_second = new_frames_per_second;
+    context_pointer = std::make_unique<AudioContext>(frames_per_second);
+    make_voice_pools();
+  }
+}
+
+// allocates, so only call this while stopped
+void Engine::set_max_polyphony(int new_max_polyphony) {
+  max_polyphony = new_max_polyphony;
+  for (auto &voice_pool_pointer : voice_pool_pointers) {
+    if (voice_pool_pointer != nullptr) {
+      voice_pool_pointer->resize(max_polyphony);
+    }
+  }
+  reserve_active_voices();
+}
+
+// starts and stops threads, so only call this while stopped
+void Engine::set_worker_count(int worker_count) {
+  workers_pointer = std::make_unique<RenderWorkers>(worker_count);
+  reserve_active_voices();
+}
+
+// so collecting active voices never allocates on the audio thread
+void Engine::reserve_active_voices() {
+  auto voice_count = 0;
+  for (const auto &voice_pool_pointer : voice_pool_pointers) {
+    if (voice_pool_pointer != nullptr) {
+      voice_count =
+          voice_count + static_cast<int>(voice_pool_pointer->voices.size());
+    }
+  }
+  workers_pointer->active_voice_pointers.reserve(voice_count);
+}
+
+auto Engine::get_voice_pool(int instrument_id) -> VoicePool & {
+  // registered after we started
+  if (instrument_id >= static_cast<int>(voice_pool_pointers.size()) ||
+      voice_pool_pointers[instrument_id] == nullptr) {
+    return *voice_pool_pointers[DEFAULT_INSTRUMENT_ID];
+  }
+  return *voice_pool_pointers[instrument_id];
+}
+
+// round positions on the timeline, not durations, so errors don't add up
+auto Engine::get_frame(double time) const -> int64_t {
+  return std::llround(time * frames_per_second);
+}
+
+// returns how long after now the last note will have finished
+// if the audio thread is running, starts at its next block
+auto Engine::start_feeding(const Performance &performance, double seek_time,
+                           double lead_in_time) -> double {
+  silence();
+  performance_pointer = &performance;
+  feed_seek_frame = get_frame(seek_time);
+  auto lead_in_frames = get_frame(lead_in_time);
+  feed_origin_frame = current_frame.load() + lead_in_frames;
+  auto final_frame = lead_in_frames;
+  for (auto note = 0; note < performance.get_note_count(); note = note + 1) {
+    auto note_end_frame =
+        get_frame(performance.start_times[note] + performance.durations[note]);
+    if (note_end_frame > feed_seek_frame) {
+      auto start_frame =
+          std::max(get_frame(performance.start_times[note]), feed_seek_frame);
+      auto true_duration =
+          get_voice_pool(performance.instrument_ids[note])
+              .prototype_pointer->get_true_duration(static_cast<float>(
+                  (note_end_frame - start_frame) / frames_per_second));
+      final_frame = std::max(
+          final_frame, lead_in_frames + start_frame - feed_seek_frame +
+                           get_frame(true_duration));
+    }
+  }
+  return final_frame / frames_per_second;
+}
+
+// adds the rest of the clip to the mono bus
+void ClipVoice::render(float *bus_pointer, int frames) {
+  const auto &samples = *clip_pointer;
+  auto sounding_frames = static_cast<int>(
+      std::min(static_cast<int64_t>(frames - delay_frames),
+               static_cast<int64_t>(samples.size()) - position));
+  for (auto frame = 0; frame < sounding_frames; frame = frame + 1) {
+    bus_pointer[delay_frames + frame] += samples[position + frame];
+  }
+  position = position + sounding_frames;
+  delay_frames = 0;
+  if (position >= static_cast<int64_t>(samples.size())) {
+    active = false;
+  }
+}
+
+// renders notes starting together by themselves, unless we already have
+// notes are keyed by everything that changes how they sound
+auto Engine::get_clip(int first_note, int end_note) -> ChordAudio {
+  const auto &performance = *performance_pointer;
+  auto clip_start_frame = get_frame(performance.start_times[first_note]);
+  clip_key.clear();
+  clip_key.frames_per_second = frames_per_second;
+  for (auto note = first_note; note < end_note; note = note + 1) {
+    clip_key.instrument_ids.push_back(performance.instrument_ids[note]);
+    clip_key.frequencies.push_back(performance.frequencies[note]);
+    clip_key.amplitudes.push_back(performance.amplitudes[note]);
+    clip_key.end_frames.push_back(get_frame(performance.start_times[note] +
+                                            performance.durations[note]) -
+                                  clip_start_frame);
+  }
+  auto clip = chord_cache_pointer->get(clip_key);
+  if (clip != nullptr) {
+    return clip;
+  }
+  std::vector<float> samples;
+  std::array<float, MAX_BLOCK_FRAMES> scratch{};
+  for (auto note = first_note; note < end_note; note = note + 1) {
+    const auto &prototype =
+        *get_voice_pool(performance.instrument_ids[note]).prototype_pointer;
+    auto instrument_pointer = prototype.new_voice_pointer();
+    auto note_frames = clip_key.end_frames[note - first_note];
+    instrument_pointer->start(
+        performance.frequencies[note], performance.amplitudes[note],
+        prototype.get_true_duration(
+            static_cast<float>(note_frames / frames_per_second)));
+    size_t position = 0;
+    while (!instrument_pointer->done()) {
+      instrument_pointer->render(scratch.data(), MAX_BLOCK_FRAMES);
+      if (samples.size() < position + MAX_BLOCK_FRAMES) {
+        samples.resize(position + MAX_BLOCK_FRAMES, 0.0F);
+      }
+      for (auto frame = 0; frame < MAX_BLOCK_FRAMES; frame = frame + 1) {
+        samples[position + frame] += scratch[frame];
+      }
+      position = position + MAX_BLOCK_FRAMES;
+    }
+  }
+  clip = std::make_shared<const std::vector<float>>(std::move(samples));
+  chord_cache_pointer->add(clip_key, clip);
+  return clip;
+}
+
+// queue notes starting together on the same instrument as one clip
+// so we can still mute instruments
+// returns false when we should stop feeding for now
+auto Engine::feed_clip(int64_t end_frame) -> bool {
+  const auto &performance = *performance_pointer;
+  auto note_count = performance.get_note_count();
+  auto start_time = performance.start_times[next_note];
+  auto instrument_id = performance.instrument_ids[next_note];
+  auto notes_end_frame =
+      get_frame(start_time + performance.durations[next_note]);
+  auto end_note = next_note + 1;
+  while (end_note < note_count &&
+         performance.start_times[end_note] == start_time &&
+         performance.instrument_ids[end_note] == instrument_id) {
+    notes_end_frame = std::max(
+        notes_end_frame,
+        get_frame(start_time + performance.durations[end_note]));
+    end_note = end_note + 1;
+  }
+  // skip notes that finished before the seek time, without rendering them
+  if (notes_end_frame <= feed_seek_frame) {
+    next_note = end_note;
+    return true;
+  }
+  auto clip_start_frame = get_frame(start_time);
+  // chords sounding at the seek time start over from there, note by note,
+  // just like when we don't cache
+  if (clip_start_frame < feed_seek_frame) {
+    return feed_note(end_frame);
+  }
+  auto start_frame = feed_origin_frame + clip_start_frame - feed_seek_frame;
+  if (start_frame >= end_frame) {
+    return false;
+  }
+  auto clip = get_clip(next_note, end_note);
+  if (!note_event_queue.push(NoteEvent{start_frame,
+                                       &get_voice_pool(instrument_id), 0.0F,
+                                       0.0F, 0.0F, generation.load(),
+                                       clip.get()})) {
+    // try again next time
+    return false;
+  }
+  held_clips.emplace(clip.get(), clip);
+  next_note = end_note;
+  return true;
+}
+
+// the audio thread is done with these
+void Engine::release_finished_clips() {
+  auto *finished_pointer = finished_clip_queue.get_front();
+  while (finished_pointer != nullptr) {
+    auto held = held_clips.find(*finished_pointer);
+    if (held != held_clips.end()) {
+      held_clips.erase(held);
+    }
+    finished_clip_queue.pop();
+    finished_pointer = finished_clip_queue.get_front();
+  }
+}
+
+// returns false when we should stop feeding for now
+auto Engine::feed_note(int64_t end_frame) -> bool {
+  const auto &performance = *performance_pointer;
+  auto note_start_time = performance.start_times[next_note];
+  auto note_end_frame =
+      get_frame(note_start_time + performance.durations[next_note]);
+  // skip notes that finished before the seek time
+  if (note_end_frame > feed_seek_frame) {
+    // notes sounding at the seek time start over from there
+    auto note_start_frame =
+        std::max(get_frame(note_start_time), feed_seek_frame);
+    auto start_frame = feed_origin_frame + note_start_frame - feed_seek_frame;
+    if (start_frame >= end_frame) {
+      return false;
+    }
+    auto &voice_pool = get_voice_pool(performance.instrument_ids[next_note]);
+    if (!note_event_queue.push(NoteEvent{
+            start_frame, &voice_pool, performance.frequencies[next_note],
+            performance.amplitudes[next_note],
+            voice_pool.prototype_pointer->get_true_duration(
+                static_cast<float>((note_end_frame - note_start_frame) /
+                                   frames_per_second)),
+            generation.load()})) {
+      // try again next time
+      return false;
+    }
+  }
+  next_note = next_note + 1;
+  return true;
+}
+
+// queue notes starting before end_frame, until the queue is full
+// notes are sorted by start time
+void Engine::feed(int64_t end_frame) {
+  release_finished_clips();
+  if (performance_pointer == nullptr) {
+    return;
+  }
+  while (next_note < performance_pointer->get_note_count()) {
+    auto fed = chord_cache_pointer == nullptr ? feed_note(end_frame)
+                                              : feed_clip(end_frame);
+    if (!fed) {
+      return;
+    }
+  }
+}
+
+void Engine::feed_ahead() {
+  feed(current_frame.load() +
+       std::llround(LOOKAHEAD_SECONDS * frames_per_second));
+}
+
+// the audio thread stops everything at its next block
+void Engine::silence() {
+  performance_pointer = nullptr;
+  next_note = 0;
+  // the audio thread finishes held clips as it drops them
+  generation = generation.load() + 1;
+}
+
+// only while the audio thread isn't running
+void Engine::clear() {
+  note_event_queue.clear();
+  performance_pointer = nullptr;
+  next_note = 0;
+  current_frame = 0;
+  timeline_position = 0.0;
+  rendered_generation = generation.load();
+  tempo_scale = 1.0;
+  master_gain = 1.0;
+  stopped = false;
+  stop_voices();
+  unmute_voice_pools();
+  held_clips.clear();
+  finished_clip_queue.clear();
+}
+
+void Engine::unmute_voice_pools() {
+  for (auto &voice_pool_pointer : voice_pool_pointers) {
+    if (voice_pool_pointer != nullptr) {
+      voice_pool_pointer->muted = false;
+    }
+  }
+}
+
+void Engine::stop_voices() {
+  for (auto &voice_pool_pointer : voice_pool_pointers) {
+    if (voice_pool_pointer != nullptr) {
+      voice_pool_pointer->clear();
+    }
+  }
+  for (auto &clip_voice : clip_voices) {
+    if (clip_voice.active) {
+      clip_voice.active = false;
+      finish_clip(clip_voice.clip_pointer);
+    }
+  }
+}
+
+// if the queue is full, the feeder holds the clip until we clear
+void Engine::finish_clip(const std::vector<float> *clip_pointer) {
+  finished_clip_queue.push(clip_pointer);
+}
+
+// only the audio thread calls this, between blocks
+void Engine::apply_control_messages() {
+  auto *message_pointer = control_queue.get_front();
+  while (message_pointer != nullptr) {
+    const auto &message = *message_pointer;
+    // newer messages wait until we see their generation
+    if (message.generation > rendered_generation) {
+      return;
+    }
+    // older messages were for what we played before
+    if (message.generation < rendered_generation) {
+      control_queue.pop();
+      message_pointer = control_queue.get_front();
+      continue;
+    }
+    switch (message.control_type) {
+      case master_gain_control:
+        master_gain = std::max(message.value, 0.0);
+        break;
+      case tempo_scale_control:
+        if (message.value > 0) {
+          tempo_scale = message.value;
+        }
+        break;
+      case stop_control:
+        stop_voices();
+        stopped = true;
+        break;
+      case mute_control:
+      case unmute_control:
+        if (message.instrument_id >= 0 &&
+            message.instrument_id <
+                static_cast<int>(voice_pool_pointers.size()) &&
+            voice_pool_pointers[message.instrument_id] != nullptr) {
+          auto &voice_pool = *voice_pool_pointers[message.instrument_id];
+          voice_pool.muted = message.control_type == mute_control;
+          if (voice_pool.muted) {
+            voice_pool.clear();
+            for (auto &clip_voice : clip_voices) {
+              if (clip_voice.active &&
+                  clip_voice.voice_pool_pointer == &voice_pool) {
+                clip_voice.active = false;
+                finish_clip(clip_voice.clip_pointer);
+              }
+            }
+          }
+        }
+        break;
+    }
+    control_queue.pop();
+    message_pointer = control_queue.get_front();
+  }
+}
+
+void Engine::start_clip(const NoteEvent &note_event, int delay_frames) {
+  if (note_event.voice_pool_pointer->muted) {
+    finish_clip(note_event.clip_pointer);
+    return;
+  }
+  // when every clip voice is busy, steal the one furthest along
+  auto *chosen_pointer = &clip_voices[0];
+  for (auto &clip_voice : clip_voices) {
+    if (!clip_voice.active) {
+      chosen_pointer = &clip_voice;
+      break;
+    }
+    if (clip_voice.position > chosen_pointer->position) {
+      chosen_pointer = &clip_voice;
+    }
+  }
+  auto &clip_voice = *chosen_pointer;
+  if (clip_voice.active) {
+    finish_clip(clip_voice.clip_pointer);
+  }
+  clip_voice.clip_pointer = note_event.clip_pointer;
+  clip_voice.voice_pool_pointer = note_event.voice_pool_pointer;
+  clip_voice.position = 0;
+  clip_voice.delay_frames = delay_frames;
+  clip_voice.active = true;
+}
+
+// adds to left and right
+void Engine::render(float *left_pointer, float *right_pointer, int frames) {
+  auto first_frame = 0;
+  while (first_frame < frames) {
+    auto block_frames = std::min(MAX_BLOCK_FRAMES, frames - first_frame);
+    auto requested_generation = generation.load();
+    if (requested_generation != rendered_generation) {
+      stop_voices();
+      rendered_generation = requested_generation;
+      // a new performance has its own volume, tempo and mutes
+      tempo_scale = 1.0;
+      master_gain = 1.0;
+      unmute_voice_pools();
+      stopped = false;
+    }
+    auto block_start_gain = master_gain;
+    apply_control_messages();
+    auto block_start_position = timeline_position;
+    auto block_end_position = block_start_position + block_frames * tempo_scale;
+    // older events were queued before we started over
+    auto *old_event_pointer = note_event_queue.get_front();
+    while (old_event_pointer != nullptr &&
+           old_event_pointer->generation < rendered_generation) {
+      if (old_event_pointer->clip_pointer != nullptr) {
+        finish_clip(old_event_pointer->clip_pointer);
+      }
+      note_event_queue.pop();
+      old_event_pointer = note_event_queue.get_front();
+    }
+    // voices start at their exact frame within the block
+    // newer events wait until we see their generation
+    auto *note_event_pointer = note_event_queue.get_front();
+    while (note_event_pointer != nullptr &&
+           note_event_pointer->generation == rendered_generation &&
+           static_cast<double>(note_event_pointer->start_frame) <
+               block_end_position) {
+      const auto &note_event = *note_event_pointer;
+      auto delay_frames = static_cast<int>(std::clamp(
+          (static_cast<double>(note_event.start_frame) - block_start_position) /
+              tempo_scale,
+          0.0, block_frames - 1.0));
+      if (stopped) {
+        // drop notes until we start over
+        if (note_event.clip_pointer != nullptr) {
+          finish_clip(note_event.clip_pointer);
+        }
+      } else if (note_event.clip_pointer != nullptr) {
+        start_clip(note_event, delay_frames);
+      } else if (!note_event.voice_pool_pointer->muted) {
+        // notes starting now play at the new tempo
+        auto &voice_pool = *note_event.voice_pool_pointer;
+        voice_pool.start_voice(
+            note_event.start_frame, delay_frames, note_event.frequency,
+            note_event.amplitude,
+            voice_pool.prototype_pointer->get_true_duration(
+                static_cast<float>(note_event.duration / tempo_scale)));
+      }
+      note_event_queue.pop();
+      note_event_pointer = note_event_queue.get_front();
+    }
+    mono_block.fill(0.0F);
+    auto &active_voice_pointers = workers_pointer->active_voice_pointers;
+    active_voice_pointers.clear();
+    for (auto &voice_pool_pointer : voice_pool_pointers) {
+      if (voice_pool_pointer != nullptr && !voice_pool_pointer->muted) {
+        for (auto &voice : voice_pool_pointer->voices) {
+          if (voice.active) {
+            active_voice_pointers.push_back(&voice);
+          }
+        }
+      }
+    }
+    workers_pointer->render(mono_block.data(), block_frames);
+    // clips are just copies, so they don't need the workers
+    active_clip_count = 0;
+    for (auto &clip_voice : clip_voices) {
+      if (clip_voice.active) {
+        active_clip_count = active_clip_count + 1;
+        clip_voice.render(mono_block.data(), block_frames);
+        if (!clip_voice.active) {
+          finish_clip(clip_voice.clip_pointer);
+        }
+      }
+    }
+    // one stereo mix for the whole block
+    // ramp the gain across the block, so changes don't click
+    auto gain_step = (master_gain - block_start_gain) / block_frames;
+    for (auto frame = 0; frame < block_frames; frame = frame + 1) {
+      auto sample = static_cast<float>(
+          mono_block[frame] * (block_start_gain + gain_step * (frame + 1)));
+      left_pointer[first_frame + frame] += sample;
+      right_pointer[first_frame + frame] += sample;
+    }
+    timeline_position = block_end_position;
+    current_frame = static_cast<int64_t>(std::floor(timeline_position));
+    first_frame = first_frame + block_frames;
+  }
+}
+
+// for offline renders, where we feed and render on the same thread
+void Engine::feed_and_render(float *left_pointer, float *right_pointer,
+                             int frames) {
+  auto first_frame = 0;
+  while (first_frame < frames) {
+    auto block_frames = std::min(MAX_BLOCK_FRAMES, frames - first_frame);
+    feed(current_frame.load() + block_frames);
+    auto start = std::chrono::steady_clock::now();
+    render(left_pointer + first_frame, right_pointer + first_frame,
+           block_frames);
+    record_stats(start, block_frames, false);
+    first_frame = first_frame + block_frames;
+  }
+}
+
+void Engine::record_stats(std::chrono::steady_clock::time_point start,
+                          int frames, bool has_deadline) {
+  stats.record(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count(),
+      std::llround(frames * NANOSECONDS_PER_SECOND / frames_per_second),
+      static_cast<int>(workers_pointer->active_voice_pointers.size()) +
+          active_clip_count,
+      has_deadline);
+}
+
+auto Engine::get_active_count() const -> int {
+  auto active_count = 0;
+  for (const auto &voice_pool_pointer : voice_pool_pointers) {
+    if (voice_pool_pointer != nullptr) {
+      active_count = active_count + voice_pool_pointer->get_active_count();
+    }
+  }
+  return active_count;
+}
+
+void Engine::audio_callback(gam::AudioIOData &audio_io) {
+  auto &engine = audio_io.user<Engine>();
+  auto start = std::chrono::steady_clock::now();
+  audio_io.zeroOut();
+  auto frames = audio_io.framesPerBuffer();
+  engine.render(audio_io.outBuffer(0), audio_io.outBuffer(1), frames);
+  // gamma doesn't pass on device underruns, so count missed deadlines
+  engine.record_stats(start, frames, true);
+}
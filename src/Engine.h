@@ -0,0 +1,165 @@
+#pragma once
+
+#include <QString>
+#include <chrono>
+#include <unordered_map>
+
+#include "ChordAudioCache.h"
+#include "EngineStats.h"
+#include "InstrumentRegistry.h"
+#include "Performance.h"
+#include "RenderWorkers.h"
+#include "SpscQueue.h"
+#include "VoicePool.h"
+
+// how far ahead of the audio thread we queue notes
+const auto LOOKAHEAD_SECONDS = 2.0;
+const auto NOTE_EVENT_CAPACITY = 4096;
+const auto MAX_CLIP_VOICES = 64;
+const auto CONTROL_MESSAGE_CAPACITY = 256;
+// every held clip finishes once, and we only hold what's queued, sounding,
+// or finished since we last looked
+const auto FINISHED_CLIP_CAPACITY = 4 * NOTE_EVENT_CAPACITY;
+
+enum ControlType {
+  master_gain_control,
+  tempo_scale_control,
+  stop_control,
+  mute_control,
+  unmute_control,
+};
+
+// sent from the gui to the audio thread, while we play
+class ControlMessage {
+ public:
+  ControlType control_type;
+  double value = 0.0;
+  int instrument_id = 0;
+  // messages from an older generation are dropped, like note events
+  int generation = 0;
+};
+
+class NoteEvent {
+ public:
+  int64_t start_frame;
+  // for clips too, so we can mute them
+  VoicePool *voice_pool_pointer;
+  float frequency;
+  float amplitude;
+  float duration;
+  // events from an older generation are dropped
+  int generation;
+  // instead of a note, play back a chord we rendered before
+  const std::vector<float> *clip_pointer = nullptr;
+};
+
+// plays back rendered chord audio, for one instrument
+class ClipVoice {
+ public:
+  const std::vector<float> *clip_pointer = nullptr;
+  VoicePool *voice_pool_pointer = nullptr;
+  int64_t position = 0;
+  int delay_frames = 0;
+  bool active = false;
+
+  void render(float *bus_pointer, int frames);
+};
+
+// turns a performance into sound, a block at a time
+// doesn't know about devices, so we can use it live or offline
+// notes are fed in a window ahead of the audio thread, so the queue
+// only grows with how many notes sound at once, not with the song
+class Engine {
+ public:
+  double frames_per_second;
+  // before the voices, so it outlives them
+  std::unique_ptr<AudioContext> context_pointer;
+  int max_polyphony;
+  StealingPolicy stealing_policy;
+  // indexed by instrument id, null for ids without an instrument
+  std::vector<std::unique_ptr<VoicePool>> voice_pool_pointers;
+  // chords we rendered before, maybe shared with other engines
+  // null to synthesize every note as we go
+  ChordAudioCache *chord_cache_pointer = nullptr;
+  // filled by the feeding thread, emptied by the audio thread
+  SpscQueue<NoteEvent> note_event_queue =
+      SpscQueue<NoteEvent>(NOTE_EVENT_CAPACITY);
+  // clips the audio thread is done with, because they ended, were stolen
+  // or stopped, or were dropped before they started
+  // filled by the audio thread, emptied by the feeding thread
+  SpscQueue<const std::vector<float> *> finished_clip_queue =
+      SpscQueue<const std::vector<float> *>(FINISHED_CLIP_CAPACITY);
+  // filled by the gui thread, emptied by the audio thread between blocks
+  SpscQueue<ControlMessage> control_queue =
+      SpscQueue<ControlMessage>(CONTROL_MESSAGE_CAPACITY);
+  // where we are in the performance, in frames at the written tempo
+  // written by the audio thread only
+  std::atomic<int64_t> current_frame = 0;
+  // bumped by the feeding thread to drop everything queued or sounding
+  // so we can start over without stopping the audio thread
+  std::atomic<int> generation = 0;
+  // only the audio thread uses these
+  int rendered_generation = 0;
+  std::array<ClipVoice, MAX_CLIP_VOICES> clip_voices{};
+  // in the last block
+  int active_clip_count = 0;
+  // current_frame, before rounding, because tempo_scale can be fractional
+  double timeline_position = 0.0;
+  double tempo_scale = 1.0;
+  double master_gain = 1.0;
+  // until we start over
+  bool stopped = false;
+
+  // only the feeding thread uses these
+  const Performance *performance_pointer = nullptr;
+  int next_note = 0;
+  int64_t feed_seek_frame = 0;
+  // where the seek frame will be on the audio thread
+  int64_t feed_origin_frame = 0;
+  // keeps clips alive until the audio thread says it's done with them
+  // clips play one sample per frame, whatever the tempo, so we can't tell
+  // from the timeline
+  // keyed by what we queued, once for each time we queued it
+  std::unordered_multimap<const std::vector<float> *, ChordAudio> held_clips;
+  // reused, so looking up a cached chord doesn't allocate
+  ChordKey clip_key;
+  std::array<float, MAX_BLOCK_FRAMES> mono_block{};
+  EngineStats stats;
+  // pointer so we can change the number of threads
+  std::unique_ptr<RenderWorkers> workers_pointer =
+      std::make_unique<RenderWorkers>();
+
+  explicit Engine(double frames_per_second_input,
+                  int max_polyphony_input = DEFAULT_MAX_POLYPHONY,
+                  StealingPolicy stealing_policy_input = steal_oldest);
+
+  void make_voice_pools();
+  void set_frames_per_second(double new_frames_per_second);
+  void set_max_polyphony(int new_max_polyphony);
+  void set_worker_count(int worker_count);
+  void reserve_active_voices();
+  [[nodiscard]] auto get_voice_pool(int instrument_id) -> VoicePool &;
+  [[nodiscard]] auto get_frame(double time) const -> int64_t;
+  // the performance must outlive the feeding
+  auto start_feeding(const Performance &performance, double seek_time,
+                     double lead_in_time) -> double;
+  [[nodiscard]] auto get_clip(int first_note, int end_note) -> ChordAudio;
+  auto feed_note(int64_t end_frame) -> bool;
+  auto feed_clip(int64_t end_frame) -> bool;
+  void release_finished_clips();
+  void feed(int64_t end_frame);
+  void feed_ahead();
+  void silence();
+  void clear();
+  void stop_voices();
+  void unmute_voice_pools();
+  void apply_control_messages();
+  void finish_clip(const std::vector<float> *clip_pointer);
+  void start_clip(const NoteEvent &note_event, int delay_frames);
+  void render(float *left_pointer, float *right_pointer, int frames);
+  void feed_and_render(float *left_pointer, float *right_pointer, int frames);
+  void record_stats(std::chrono::steady_clock::time_point start, int frames,
+                    bool has_deadline);
+  [[nodiscard]] auto get_active_count() const -> int;
+  static void audio_callback(gam::AudioIOData &audio_io);
+};
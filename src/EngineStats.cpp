@@ -0,0 +1,89 @@
+#include "EngineStats.h"
+
+#include <QFile>
+#include <QJsonDocument>
+
+void EngineStats::reset() {
+  callbacks = 0;
+  xruns = 0;
+  buffer_nanoseconds = 0;
+  last_render_nanoseconds = 0;
+  max_render_nanoseconds = 0;
+  total_render_nanoseconds = 0;
+  active_voices = 0;
+  max_active_voices = 0;
+}
+
+void EngineStats::record(int64_t render_nanoseconds,
+                         int64_t buffer_nanoseconds_input,
+                         int active_voices_input, bool has_deadline) {
+  callbacks.store(callbacks.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  if (has_deadline && render_nanoseconds > buffer_nanoseconds_input) {
+    xruns.store(xruns.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+  }
+  buffer_nanoseconds.store(buffer_nanoseconds_input, std::memory_order_relaxed);
+  last_render_nanoseconds.store(render_nanoseconds, std::memory_order_relaxed);
+  if (render_nanoseconds > max_render_nanoseconds.load(std::memory_order_relaxed)) {
+    max_render_nanoseconds.store(render_nanoseconds, std::memory_order_relaxed);
+  }
+  total_render_nanoseconds.store(
+      total_render_nanoseconds.load(std::memory_order_relaxed) + render_nanoseconds,
+      std::memory_order_relaxed);
+  active_voices.store(active_voices_input, std::memory_order_relaxed);
+  if (active_voices_input > max_active_voices.load(std::memory_order_relaxed)) {
+    max_active_voices.store(active_voices_input, std::memory_order_relaxed);
+  }
+}
+
+// render time over the time the buffer lasts
+auto EngineStats::get_load() const -> double {
+  auto buffer_time = buffer_nanoseconds.load();
+  if (buffer_time == 0) {
+    return 0.0;
+  }
+  return (1.0 * last_render_nanoseconds.load()) / buffer_time;
+}
+
+auto EngineStats::get_max_load() const -> double {
+  auto buffer_time = buffer_nanoseconds.load();
+  if (buffer_time == 0) {
+    return 0.0;
+  }
+  return (1.0 * max_render_nanoseconds.load()) / buffer_time;
+}
+
+auto EngineStats::get_average_load() const -> double {
+  auto buffer_time = buffer_nanoseconds.load();
+  auto callback_count = callbacks.load();
+  if (buffer_time == 0 || callback_count == 0) {
+    return 0.0;
+  }
+  return (1.0 * total_render_nanoseconds.load()) / callback_count / buffer_time;
+}
+
+void EngineStats::to_json(QJsonObject &json_object) const {
+  json_object["callbacks"] = callbacks.load();
+  json_object["xruns"] = xruns.load();
+  json_object["buffer_seconds"] = buffer_nanoseconds.load() / NANOSECONDS_PER_SECOND;
+  json_object["last_render_seconds"] = last_render_nanoseconds.load() / NANOSECONDS_PER_SECOND;
+  json_object["max_render_seconds"] = max_render_nanoseconds.load() / NANOSECONDS_PER_SECOND;
+  json_object["load"] = get_load();
+  json_object["max_load"] = get_max_load();
+  json_object["average_load"] = get_average_load();
+  json_object["active_voices"] = active_voices.load();
+  json_object["max_active_voices"] = max_active_voices.load();
+}
+
+auto EngineStats::save(const QString &file_name) const -> bool {
+  QJsonObject json_object;
+  to_json(json_object);
+  QFile output(file_name);
+  if (!output.open(QIODevice::WriteOnly)) {
+    return false;
+  }
+  output.write(QJsonDocument(json_object).toJson());
+  output.close();
+  return true;
+}
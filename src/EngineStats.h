@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <atomic>
+
+const auto NANOSECONDS_PER_SECOND = 1000000000.0;
+
+// how close the audio callback comes to its deadline
+// only the audio thread writes, so plain atomics are enough
+class EngineStats {
+ public:
+  std::atomic<int64_t> callbacks = 0;
+  // callbacks that took longer than their buffer lasts
+  std::atomic<int64_t> xruns = 0;
+  std::atomic<int64_t> buffer_nanoseconds = 0;
+  std::atomic<int64_t> last_render_nanoseconds = 0;
+  std::atomic<int64_t> max_render_nanoseconds = 0;
+  std::atomic<int64_t> total_render_nanoseconds = 0;
+  std::atomic<int> active_voices = 0;
+  std::atomic<int> max_active_voices = 0;
+
+  // only while the audio thread isn't running
+  void reset();
+  // offline renders have no deadline, so they never miss one
+  void record(int64_t render_nanoseconds, int64_t buffer_nanoseconds_input,
+              int active_voices_input, bool has_deadline = true);
+  [[nodiscard]] auto get_load() const -> double;
+  [[nodiscard]] auto get_max_load() const -> double;
+  [[nodiscard]] auto get_average_load() const -> double;
+  void to_json(QJsonObject &json_object) const;
+  [[nodiscard]] auto save(const QString &file_name) const -> bool;
+};
@@ -0,0 +1,96 @@
+#include "EnvelopeTables.h"
+
+// rises from 0 to 1 with the same curvature as a gamma envelope
+static auto get_curve(double progress) -> double {
+  return (1 - exp(CURVATURE * progress)) / (1 - exp(CURVATURE));
+}
+
+static void fill_table(std::vector<float> &table, double frames_per_second,
+                       float seconds, float start_level, float end_level) {
+  auto frames = static_cast<int>(std::llround(seconds * frames_per_second));
+  table.resize(frames);
+  for (auto frame = 0; frame < frames; frame = frame + 1) {
+    table[frame] = static_cast<float>(
+        start_level + (end_level - start_level) * get_curve((1.0 * frame) / frames));
+  }
+}
+
+EnvelopeTables::EnvelopeTables(double frames_per_second_input)
+    : frames_per_second(frames_per_second_input) {
+  fill_table(attack_table, frames_per_second, ATTACK_TIME, 0.0F, 1.0F);
+  fill_table(decay_table, frames_per_second, DECAY_TIME, 1.0F, SUSTAIN_RATIO);
+  fill_table(release_table, frames_per_second, RELEASE_TIME, SUSTAIN_RATIO, 0.0F);
+}
+
+auto EnvelopeTables::get_table(int segment) const -> const std::vector<float> & {
+  if (segment == attack_segment) {
+    return attack_table;
+  }
+  if (segment == decay_segment) {
+    return decay_table;
+  }
+  if (segment != release_segment) {
+    qCritical("No table for segment %d!", segment);
+  }
+  return release_table;
+}
+
+TableEnvelope::TableEnvelope(const EnvelopeTables &tables_input)
+    : tables(tables_input) {}
+
+void TableEnvelope::start(float amplitude_input, float sustain_time) {
+  amplitude = amplitude_input;
+  segment = attack_segment;
+  segment_frame = 0;
+  sustain_frames = static_cast<int>(
+      std::llround(std::max(sustain_time, 0.0F) * tables.frames_per_second));
+}
+
+auto TableEnvelope::get_segment_frames() const -> int {
+  if (segment == sustain_segment) {
+    return sustain_frames;
+  }
+  return static_cast<int>(tables.get_table(segment).size());
+}
+
+void TableEnvelope::apply(float *destination, int frames) {
+  auto frame = 0;
+  while (frame < frames) {
+    if (segment == done_segment) {
+      std::fill(destination + frame, destination + frames, 0.0F);
+      return;
+    }
+    auto run_frames =
+        std::min(frames - frame, get_segment_frames() - segment_frame);
+    if (segment == sustain_segment) {
+      auto level = amplitude * SUSTAIN_RATIO;
+      for (auto index = 0; index < run_frames; index = index + 1) {
+        destination[frame + index] = destination[frame + index] * level;
+      }
+    } else {
+      const auto *table_pointer = tables.get_table(segment).data() + segment_frame;
+      for (auto index = 0; index < run_frames; index = index + 1) {
+        destination[frame + index] =
+            destination[frame + index] * amplitude * table_pointer[index];
+      }
+    }
+    frame = frame + run_frames;
+    segment_frame = segment_frame + run_frames;
+    if (segment_frame >= get_segment_frames()) {
+      segment = segment + 1;
+      segment_frame = 0;
+    }
+  }
+}
+
+auto TableEnvelope::done() const -> bool { return segment == done_segment; }
+
+auto TableEnvelope::get_level() const -> float {
+  if (segment == done_segment) {
+    return 0.0F;
+  }
+  if (segment == sustain_segment) {
+    return amplitude * SUSTAIN_RATIO;
+  }
+  return amplitude * tables.get_table(segment)[segment_frame];
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QtGlobal>
+#include <cmath>
+#include <vector>
+
+const auto ATTACK_TIME = 0.05F;
+const auto DECAY_TIME = 0.2F;
+const auto RELEASE_TIME = 0.1F;
+const auto SUSTAIN_RATIO = 0.6F;
+const auto CURVATURE = -4;
+
+enum EnvelopeSegment {
+  attack_segment = 0,
+  decay_segment = 1,
+  sustain_segment = 2,
+  release_segment = 3,
+  done_segment = 4,
+};
+
+// the attack, decay, and release shapes only depend on the sample rate
+// so compute them once, scaled to an amplitude of 1
+class EnvelopeTables {
+ public:
+  const double frames_per_second;
+  std::vector<float> attack_table;
+  std::vector<float> decay_table;
+  std::vector<float> release_table;
+
+  explicit EnvelopeTables(double frames_per_second_input);
+  // just a lookup, so the audio thread can call it
+  [[nodiscard]] auto get_table(int segment) const -> const std::vector<float> &;
+};
+
+// plays back the tables, only the sustain varies by note
+class TableEnvelope {
+ public:
+  const EnvelopeTables &tables;
+  float amplitude = 0.0F;
+  int segment = done_segment;
+  int segment_frame = 0;
+  int sustain_frames = 0;
+
+  explicit TableEnvelope(const EnvelopeTables &tables_input);
+  void start(float amplitude_input, float sustain_time);
+  [[nodiscard]] auto get_segment_frames() const -> int;
+  // multiply destination by the envelope
+  void apply(float *destination, int frames);
+  [[nodiscard]] auto done() const -> bool;
+  [[nodiscard]] auto get_level() const -> float;
+};
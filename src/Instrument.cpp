@@ -1,12 +1,5 @@
 #include "Instrument.h"
 
-void Instrument::onProcess(gam::AudioIOData &audio_io) {
-  while (audio_io()) {
-    auto sample_1 = get_sample();
-    audio_io.out(0) += sample_1;
-    audio_io.out(1) += sample_1;
-  }
-  if (done()) {
-    free();
-  }
+auto Instrument::get_true_duration(float duration) const -> float {
+  return duration;
 }
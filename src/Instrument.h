@@ -1,14 +1,27 @@
 #pragma once
 
 #include "Gamma/AudioIO.h"
-#include "Gamma/Envelope.h"
-#include "Gamma/Oscillator.h"
-#include "Gamma/Scheduler.h"
 
-class Instrument : public gam::Process<gam::AudioIOData> {
+// longest block we render at once; longer buffers are split
+const auto MAX_BLOCK_FRAMES = 512;
+
+// an instrument is also one voice of itself
+// voice pools are filled with new_voice_pointer before playing
+// register an instrument as linear only if a note at twice the amplitude
+// sounds like two notes starting together, so unisons can share a voice
+class Instrument {
  public:
-  virtual auto add(gam::Scheduler &scheduler, float start_time, float frequency, float amplitude, float duration) const -> float = 0;
-  virtual auto get_sample() -> float = 0;
+  virtual ~Instrument() = default;
+
+  [[nodiscard]] virtual auto new_voice_pointer() const
+      -> std::unique_ptr<Instrument> = 0;
+  // the instrument may need to play longer than asked
+  [[nodiscard]] virtual auto get_true_duration(float duration) const -> float;
+  // reset this voice for a new note, without allocating
+  virtual void start(float frequency, float amplitude, float duration) = 0;
+  // write (don't add) the next frames of mono output to destination
+  virtual void render(float *destination, int frames) = 0;
   virtual auto done() -> bool = 0;
-  void onProcess(gam::AudioIOData &audio_io) override;
+  // how loud the voice is now, for voice stealing
+  virtual auto get_level() -> float = 0;
 };
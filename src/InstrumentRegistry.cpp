@@ -0,0 +1,95 @@
+#include "InstrumentRegistry.h"
+
+#include <QtDebug>
+#include <algorithm>
+
+#include "DefaultInstrument.h"
+
+InstrumentRegistry::InstrumentRegistry() {
+  // a wavetable times an envelope, starting in phase
+  register_factory(
+      "default",
+      [](const AudioContext &context) {
+        return std::make_unique<DefaultInstrument>(context);
+      },
+      true);
+}
+
+auto InstrumentRegistry::get_registry() -> InstrumentRegistry & {
+  static InstrumentRegistry registry;
+  return registry;
+}
+
+// call with the lock held
+auto InstrumentRegistry::add_name(const QString &name) -> int {
+  auto found = ids.find(name);
+  if (found != ids.end()) {
+    return found->second;
+  }
+  auto instrument_id = static_cast<int>(names.size());
+  ids[name] = instrument_id;
+  names.push_back(name);
+  factories.emplace_back();
+  resolved_ids.push_back(DEFAULT_INSTRUMENT_ID);
+  linear_flags.push_back(false);
+  warned_flags.push_back(false);
+  return instrument_id;
+}
+
+auto InstrumentRegistry::intern(const QString &name) -> int {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto instrument_id = add_name(name);
+  // only say this once per song, not once per note
+  if (!factories[instrument_id] && !warned_flags[instrument_id]) {
+    warned_flags[instrument_id] = true;
+    qInfo() << QString("Instrument %1 not defined; using the default instrument!").arg(name);
+  }
+  return instrument_id;
+}
+
+void InstrumentRegistry::start_song() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  std::fill(warned_flags.begin(), warned_flags.end(), false);
+}
+
+void InstrumentRegistry::register_factory(const QString &name,
+                                          InstrumentFactory factory,
+                                          bool linear) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto instrument_id = add_name(name);
+  factories[instrument_id] = std::move(factory);
+  resolved_ids[instrument_id] = instrument_id;
+  linear_flags[instrument_id] = linear;
+  factory_generation = factory_generation + 1;
+}
+
+auto InstrumentRegistry::resolve(int instrument_id) -> int {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  return resolved_ids[instrument_id];
+}
+
+auto InstrumentRegistry::get_linear_flags() -> std::vector<bool> {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  return linear_flags;
+}
+
+auto InstrumentRegistry::get_instrument_count() -> int {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  return static_cast<int>(names.size());
+}
+
+auto InstrumentRegistry::get_name(int instrument_id) -> QString {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  return names[instrument_id];
+}
+
+auto InstrumentRegistry::new_prototype_pointer(int instrument_id,
+                                               const AudioContext &context)
+    -> std::unique_ptr<Instrument> {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  const auto &factory = factories[instrument_id];
+  if (!factory) {
+    return nullptr;
+  }
+  return factory(context);
+}
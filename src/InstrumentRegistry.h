@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include "AudioContext.h"
+#include "Instrument.h"
+
+// the default instrument is always interned first
+const auto DEFAULT_INSTRUMENT_ID = 0;
+
+using InstrumentFactory =
+    std::function<std::unique_ptr<Instrument>(const AudioContext &context)>;
+
+// interns instrument names to small ids when notes are loaded or edited
+// so playing never compares strings
+// a name without a factory resolves to the default instrument, and we
+// only warn about it the first time a song uses it
+class InstrumentRegistry {
+ public:
+  std::mutex registry_mutex;
+  std::map<QString, int> ids;
+  std::vector<QString> names;
+  // empty for names without an instrument
+  std::vector<InstrumentFactory> factories;
+  std::vector<int> resolved_ids;
+  // see Instrument
+  std::vector<bool> linear_flags;
+  // cleared when a song starts loading
+  std::vector<bool> warned_flags;
+  // bumped when a factory is registered, so compiled chords resolve again
+  std::atomic<int> factory_generation = 0;
+
+  InstrumentRegistry();
+  [[nodiscard]] static auto get_registry() -> InstrumentRegistry &;
+  auto add_name(const QString &name) -> int;
+  auto intern(const QString &name) -> int;
+  void start_song();
+  void register_factory(const QString &name, InstrumentFactory factory,
+                        bool linear = false);
+  [[nodiscard]] auto resolve(int instrument_id) -> int;
+  // a copy, so we can check many notes with one lock
+  [[nodiscard]] auto get_linear_flags() -> std::vector<bool>;
+  [[nodiscard]] auto get_instrument_count() -> int;
+  [[nodiscard]] auto get_name(int instrument_id) -> QString;
+  // null if the id has no instrument
+  [[nodiscard]] auto new_prototype_pointer(int instrument_id,
+                                           const AudioContext &context)
+      -> std::unique_ptr<Instrument>;
+};
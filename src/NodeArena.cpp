@@ -0,0 +1,75 @@
+#include "NodeArena.h"
+
+auto NodeArena::allocate(size_t size) -> void * {
+  auto units = (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT;
+  auto block_size = units * ARENA_ALIGNMENT;
+  if (block_size > SLAB_SIZE) {
+    return ::operator new(size);
+  }
+  live_blocks = live_blocks + 1;
+  if (units < free_blocks.size() && !free_blocks[units].empty()) {
+    auto *block_pointer = free_blocks[units].back();
+    free_blocks[units].pop_back();
+    return block_pointer;
+  }
+  if (used_bytes + block_size > SLAB_SIZE) {
+    slabs.push_back(std::make_unique_for_overwrite<std::byte[]>(SLAB_SIZE));
+    used_bytes = 0;
+  }
+  auto *block_pointer = slabs.back().get() + used_bytes;
+  used_bytes = used_bytes + block_size;
+  return block_pointer;
+}
+
+void NodeArena::deallocate(void *block_pointer, size_t size) {
+  if (block_pointer == nullptr) {
+    return;
+  }
+  auto units = (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT;
+  if (units * ARENA_ALIGNMENT > SLAB_SIZE) {
+    ::operator delete(block_pointer);
+    return;
+  }
+  live_blocks = live_blocks - 1;
+  if (live_blocks == 0) {
+    // start over, so the next song is laid out in order again
+    free_blocks.clear();
+    slabs.resize(1);
+    used_bytes = 0;
+    return;
+  }
+  if (free_blocks.size() <= units) {
+    free_blocks.resize(units + 1);
+  }
+  free_blocks[units].push_back(block_pointer);
+}
+
+class BlockHeader {
+ public:
+  NodeArena *arena_pointer;
+  size_t size;
+};
+
+static_assert(sizeof(BlockHeader) <= ARENA_ALIGNMENT);
+
+auto NodeArena::allocate_in(NodeArena *arena_pointer, size_t size) -> void * {
+  auto *block_pointer = static_cast<std::byte *>(
+      arena_pointer == nullptr ? ::operator new(ARENA_ALIGNMENT + size)
+                               : arena_pointer->allocate(ARENA_ALIGNMENT + size));
+  *reinterpret_cast<BlockHeader *>(block_pointer) =
+      BlockHeader{arena_pointer, ARENA_ALIGNMENT + size};
+  return block_pointer + ARENA_ALIGNMENT;
+}
+
+void NodeArena::deallocate_from(void *pointer) {
+  if (pointer == nullptr) {
+    return;
+  }
+  auto *block_pointer = static_cast<std::byte *>(pointer) - ARENA_ALIGNMENT;
+  const auto &header = *reinterpret_cast<BlockHeader *>(block_pointer);
+  if (header.arena_pointer == nullptr) {
+    ::operator delete(block_pointer);
+    return;
+  }
+  header.arena_pointer->deallocate(block_pointer, header.size);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+const size_t SLAB_SIZE = 65536;
+const auto ARENA_ALIGNMENT = alignof(std::max_align_t);
+
+// hands out blocks from big contiguous slabs, for one song's nodes and data
+// blocks are handed out in order, so a node and its note or chord sit
+// together, followed by its children, like when we load a song
+// only the song's thread touches it, so no lock
+// freed blocks are reused, sorted by size
+// when every block is freed, we start over from the first slab
+// slabs go when the song does
+class NodeArena {
+ public:
+  std::vector<std::unique_ptr<std::byte[]>> slabs;
+  // bytes handed out of the newest slab
+  size_t used_bytes = SLAB_SIZE;
+  // indexed by size in units of ARENA_ALIGNMENT
+  std::vector<std::vector<void *>> free_blocks;
+  int live_blocks = 0;
+
+  // bigger objects go to the general heap
+  [[nodiscard]] auto allocate(size_t size) -> void *;
+  void deallocate(void *block_pointer, size_t size);
+
+  // for class operator news
+  // each block starts with its arena and size, so delete can find them
+  // without an arena, use the general heap
+  [[nodiscard]] static auto allocate_in(NodeArena *arena_pointer, size_t size)
+      -> void *;
+  static void deallocate_from(void *pointer);
+};
+
+// so std::allocate_shared can put data next to its node
+template <typename Value>
+class ArenaAllocator {
+ public:
+  using value_type = Value;
+  NodeArena *arena_pointer;
+
+  explicit ArenaAllocator(NodeArena *arena_pointer_input)
+      : arena_pointer(arena_pointer_input) {}
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  template <typename Other>
+  ArenaAllocator(const ArenaAllocator<Other> &other)
+      : arena_pointer(other.arena_pointer) {}
+
+  [[nodiscard]] auto allocate(size_t count) -> Value * {
+    return static_cast<Value *>(arena_pointer->allocate(count * sizeof(Value)));
+  }
+  void deallocate(Value *value_pointer, size_t count) {
+    arena_pointer->deallocate(value_pointer, count * sizeof(Value));
+  }
+  template <typename Other>
+  auto operator==(const ArenaAllocator<Other> &other) const -> bool {
+    return arena_pointer == other.arena_pointer;
+  }
+};
+
+// without an arena, use the general heap
+template <typename Value, typename... Arguments>
+[[nodiscard]] auto make_shared_in(NodeArena *arena_pointer,
+                                  Arguments &&...arguments)
+    -> std::shared_ptr<Value> {
+  if (arena_pointer == nullptr) {
+    return std::make_shared<Value>(std::forward<Arguments>(arguments)...);
+  }
+  return std::allocate_shared<Value>(ArenaAllocator<Value>(arena_pointer),
+                                     std::forward<Arguments>(arguments)...);
+}
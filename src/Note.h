@@ -5,6 +5,40 @@
 const auto NOTE_COLUMNS = 9;
 const auto NOTE_LEVEL = 2;
 
+constexpr ColumnTable NOTE_COLUMN_TABLE = {
+    ColumnDescriptor{
+        nullptr, false,
+        [](const NoteChord & /*note_chord*/) -> QVariant { return "♪"; },
+        nullptr},
+    NUMERATOR_DESCRIPTOR,
+    DENOMINATOR_DESCRIPTOR,
+    OCTAVE_DESCRIPTOR,
+    // beats cant be negative
+    ColumnDescriptor{
+        "beats", true,
+        [](const NoteChord &note_chord) -> QVariant { return note_chord.beats; },
+        [](NoteChord &note_chord, const QVariant &value) {
+          auto parsed = value.toInt();
+          if (parsed >= 0) {
+            note_chord.beats = parsed;
+            return true;
+          }
+          return false;
+        }},
+    VOLUME_RATIO_DESCRIPTOR,
+    TEMPO_RATIO_DESCRIPTOR,
+    WORDS_DESCRIPTOR,
+    ColumnDescriptor{
+        "instrument", true,
+        [](const NoteChord &note_chord) -> QVariant {
+          return note_chord.instrument;
+        },
+        [](NoteChord &note_chord, const QVariant &value) {
+          note_chord.set_instrument(value.toString());
+          return true;
+        }},
+};
+
 // TODO: removeRows data from root?
 class Note : public NoteChord {
  public:
@@ -14,14 +48,10 @@ class Note : public NoteChord {
   [[nodiscard]] auto get_level() const -> int override;
   [[nodiscard]] auto columnCount() const -> int override;
 
-  [[nodiscard]] auto flags(int column, Qt::ItemFlags default_flags) const
-      -> Qt::ItemFlags override;
-  void from_json(const QJsonObject &json_note_chord) override;
-  auto to_json(QJsonObject &json_map) const -> void override;
-  [[nodiscard]] auto data(int column, int role) const -> QVariant override;
-  auto setData(int column, const QVariant &value, int role) -> bool override;
   void test() override;
-  auto pointer_copy_self() -> std::unique_ptr<NoteChord> override;
-  auto new_child_note_chord_pointer() -> std::unique_ptr<NoteChord> override;
+  [[nodiscard]] auto pointer_copy_self(NodeArena *arena_pointer) const
+      -> std::shared_ptr<NoteChord> override;
+  [[nodiscard]] auto new_child_note_chord_pointer(
+      NodeArena *arena_pointer) const -> std::shared_ptr<NoteChord> override;
   
 };
@@ -1,69 +1,101 @@
 #include "NoteChord.h"
 
+#include "InstrumentRegistry.h"
+
 auto NoteChord::error_column(int column) -> void {
   qCritical("No column %d", column);
 }
 
+NoteChord::NoteChord(const ColumnTable &column_table)
+    : column_table_pointer(&column_table) {}
+
 // TODO: translate
 auto NoteChord::headerData(int section, Qt::Orientation orientation, int role)
     -> QVariant {
-  if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
-    if (section == symbol_column) {
-      return {};
-    }
-    if (section == numerator_column) {
-      return "Numerator";
-    };
-    if (section == denominator_column) {
-      return "Denominator";
-    };
-    if (section == octave_column) {
-      return "Octave";
-    };
-    if (section == beats_column) {
-      return "Beats";
-    };
-    if (section == volume_ratio_column) {
-      return "Volume Ratio";
-    };
-    if (section == tempo_ratio_column) {
-      return "Tempo Ratio";
-    };
-    if (section == words_column) {
-      return "Words";
-    };
-    if (section == instrument_column) {
-      return "Instrument";
-    };
-    NoteChord::error_column(section);
-  }
   // no horizontal headers
   // no headers for other roles
-  return {};
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+    return {};
+  }
+  if (section < 0 || section >= NOTE_CHORD_COLUMNS) {
+    NoteChord::error_column(section);
+    return {};
+  }
+  const auto *header = COLUMN_HEADERS[section];
+  if (header == nullptr) {
+    return {};
+  }
+  return header;
+}
+
+auto NoteChord::flags(int column, Qt::ItemFlags default_flags) const
+    -> Qt::ItemFlags {
+  if (column < 0 || column >= NOTE_CHORD_COLUMNS) {
+    NoteChord::error_column(column);
+    return Qt::NoItemFlags;
+  }
+  if (!(*column_table_pointer)[column].editable) {
+    return Qt::NoItemFlags;
+  }
+  return default_flags | Qt::ItemIsEditable;
+}
+
+auto NoteChord::data(int column, int role) const -> QVariant {
+  // no data for other roles
+  if (role != Qt::DisplayRole) {
+    return {};
+  }
+  if (column < 0 || column >= NOTE_CHORD_COLUMNS) {
+    NoteChord::error_column(column);
+    return {};
+  }
+  return (*column_table_pointer)[column].get(*this);
+}
+
+auto NoteChord::setData(int column, const QVariant &value, int role) -> bool {
+  // dont set any other role
+  if (role != Qt::EditRole) {
+    return false;
+  }
+  if (column < 0 || column >= NOTE_CHORD_COLUMNS) {
+    NoteChord::error_column(column);
+    return false;
+  }
+  const auto &column_descriptor = (*column_table_pointer)[column];
+  if (column_descriptor.set == nullptr) {
+    NoteChord::error_column(column);
+    return false;
+  }
+  return column_descriptor.set(*this, value);
 }
 
 auto NoteChord::get_ratio() const -> float {
   return (1.0F * static_cast<float>(numerator)) / static_cast<float>(denominator) * powf(OCTAVE_RATIO, static_cast<float>(octave));
 }
 
+// the same checks as editing
+// missing fields keep their defaults
 void NoteChord::from_json(const QJsonObject &json_note_chord) {
-  numerator = json_note_chord["numerator"].toInt();
-  denominator = json_note_chord["denominator"].toInt();
-  octave = json_note_chord["octave"].toInt();
-  beats = json_note_chord["beats"].toInt();
-  volume_ratio = static_cast<float>(json_note_chord["volume_ratio"].toDouble());
-  tempo_ratio = static_cast<float>(json_note_chord["tempo_ratio"].toDouble());
-  words = json_note_chord["words"].toString();
+  for (const auto &column_descriptor : *column_table_pointer) {
+    if (column_descriptor.json_key == nullptr ||
+        !json_note_chord.contains(column_descriptor.json_key)) {
+      continue;
+    }
+    if (!column_descriptor.set(
+            *this,
+            json_note_chord[column_descriptor.json_key].toVariant())) {
+      qCritical("Invalid %s!", column_descriptor.json_key);
+    }
+  }
 }
 
 auto NoteChord::to_json(QJsonObject &json_map) const -> void {
-  json_map["numerator"] = numerator;
-  json_map["denominator"] = denominator;
-  json_map["octave"] = octave;
-  json_map["beats"] = beats;
-  json_map["volume_ratio"] = volume_ratio;
-  json_map["tempo_ratio"] = tempo_ratio;
-  json_map["words"] = words;
+  for (const auto &column_descriptor : *column_table_pointer) {
+    if (column_descriptor.json_key != nullptr) {
+      json_map[column_descriptor.json_key] =
+          QJsonValue::fromVariant(column_descriptor.get(*this));
+    }
+  }
 };
 
 auto NoteChord::maybeSetNumerator(int new_numerator) -> bool {
@@ -90,6 +122,11 @@ auto NoteChord::maybeSetVolumeRatio(float new_volume_ratio) -> bool {
   return false;
 }
 
+void NoteChord::set_instrument(const QString &new_instrument) {
+  instrument = new_instrument;
+  instrument_id = InstrumentRegistry::get_registry().intern(instrument);
+}
+
 auto NoteChord::maybeSetTempoRatio(float new_tempo_ratio) -> bool {
   if (new_tempo_ratio > 0) {
     tempo_ratio = new_tempo_ratio;
@@ -2,6 +2,9 @@
 
 #include <QJsonObject>
 #include <QTest>
+#include <array>
+
+#include "NodeArena.h"
 
 const int DEFAULT_NUMERATOR = 1;
 const int DEFAULT_DENOMINATOR = 1;
@@ -10,6 +13,7 @@ const int DEFAULT_BEATS = 1;
 const auto DEFAULT_VOLUME_RATIO = 1.0F;
 const auto DEFAULT_TEMPO_RATIO = 1.0F;
 const auto OCTAVE_RATIO = 2.0F;
+const int NOTE_CHORD_COLUMNS = 9;
 
 enum ChordNoteFields {
   symbol_column = 0,
@@ -23,6 +27,28 @@ enum ChordNoteFields {
   instrument_column = 8
 };
 
+// the same for notes and chords, so the header doesn't depend on a level
+// null for no header
+constexpr std::array<const char *, NOTE_CHORD_COLUMNS> COLUMN_HEADERS = {
+    nullptr,        "Numerator",   "Denominator", "Octave",    "Beats",
+    "Volume Ratio", "Tempo Ratio", "Words",       "Instrument"};
+
+class NoteChord;
+
+// how a column shows, edits and saves its field
+struct ColumnDescriptor {
+  // null if we don't save it
+  const char *json_key;
+  bool editable;
+  auto (*get)(const NoteChord &note_chord) -> QVariant;
+  // null if we can't edit it
+  // false if the value is invalid
+  auto (*set)(NoteChord &note_chord, const QVariant &value) -> bool;
+};
+
+// one per level, so finding a cell is one lookup, not a chain of ifs
+using ColumnTable = std::array<ColumnDescriptor, NOTE_CHORD_COLUMNS>;
+
 // TODO: removeRows data from root?
 class NoteChord {
  public:
@@ -34,33 +60,93 @@ class NoteChord {
   float tempo_ratio = DEFAULT_TEMPO_RATIO;
   QString words;
   QString instrument = "default";
+  // interned, so we don't compare strings when we play
+  // starts as the id of the default instrument
+  int instrument_id = 0;
+  // pointer, so we can still copy
+  const ColumnTable *column_table_pointer;
 
+  explicit NoteChord(const ColumnTable &column_table);
   virtual ~NoteChord() = default;
 
-  virtual auto pointer_copy_self() -> std::unique_ptr<NoteChord> = 0;
-  virtual auto new_child_note_chord_pointer() -> std::unique_ptr<NoteChord> = 0;
+  // shared, and from the same arena as the node that asks
+  [[nodiscard]] virtual auto pointer_copy_self(NodeArena *arena_pointer) const
+      -> std::shared_ptr<NoteChord> = 0;
+  [[nodiscard]] virtual auto new_child_note_chord_pointer(
+      NodeArena *arena_pointer) const -> std::shared_ptr<NoteChord> = 0;
 
   static auto error_column(int column) -> void;
   [[nodiscard]] static auto headerData(int section, Qt::Orientation orientation,
                                        int role = Qt::DisplayRole) -> QVariant;
   [[nodiscard]] auto get_ratio() const -> float;
-  [[nodiscard]] virtual auto flags(int column,
-                                   Qt::ItemFlags default_flags) const
-      -> Qt::ItemFlags = 0;
+  [[nodiscard]] auto flags(int column, Qt::ItemFlags default_flags) const
+      -> Qt::ItemFlags;
 
   [[nodiscard]] virtual auto columnCount() const -> int = 0;
   [[nodiscard]] virtual auto get_level() const -> int = 0;
-  virtual void from_json(const QJsonObject &json_note_chord);
-  [[nodiscard]] virtual auto data(int column, int role) const -> QVariant = 0;
-  virtual auto setData(int column, const QVariant &value, int role) -> bool = 0;
-  virtual auto to_json(QJsonObject &json_map) const -> void;
+  void from_json(const QJsonObject &json_note_chord);
+  [[nodiscard]] auto data(int column, int role) const -> QVariant;
+  auto setData(int column, const QVariant &value, int role) -> bool;
+  auto to_json(QJsonObject &json_map) const -> void;
   auto maybeSetNumerator(int new_numerator) -> bool;
   auto maybeSetDenominator(int new_denominator) -> bool;
   auto maybeSetVolumeRatio(float new_volume_ratio) -> bool;
   auto maybeSetTempoRatio(float new_tempo_ratio) -> bool;
+  void set_instrument(const QString &new_instrument);
   void test_simple_int_field(int column);
   void test_positive_int_field(int column);
   void test_positive_double_field(int column);
   void test_string_field(int column);
   virtual void test();
 };
+
+// columns notes and chords share
+constexpr ColumnDescriptor NUMERATOR_DESCRIPTOR = {
+    "numerator", true,
+    [](const NoteChord &note_chord) -> QVariant { return note_chord.numerator; },
+    [](NoteChord &note_chord, const QVariant &value) {
+      return note_chord.maybeSetNumerator(value.toInt());
+    }};
+
+constexpr ColumnDescriptor DENOMINATOR_DESCRIPTOR = {
+    "denominator", true,
+    [](const NoteChord &note_chord) -> QVariant {
+      return note_chord.denominator;
+    },
+    [](NoteChord &note_chord, const QVariant &value) {
+      return note_chord.maybeSetDenominator(value.toInt());
+    }};
+
+constexpr ColumnDescriptor OCTAVE_DESCRIPTOR = {
+    "octave", true,
+    [](const NoteChord &note_chord) -> QVariant { return note_chord.octave; },
+    [](NoteChord &note_chord, const QVariant &value) {
+      note_chord.octave = value.toInt();
+      return true;
+    }};
+
+constexpr ColumnDescriptor VOLUME_RATIO_DESCRIPTOR = {
+    "volume_ratio", true,
+    [](const NoteChord &note_chord) -> QVariant {
+      return note_chord.volume_ratio;
+    },
+    [](NoteChord &note_chord, const QVariant &value) {
+      return note_chord.maybeSetVolumeRatio(value.toFloat());
+    }};
+
+constexpr ColumnDescriptor TEMPO_RATIO_DESCRIPTOR = {
+    "tempo_ratio", true,
+    [](const NoteChord &note_chord) -> QVariant {
+      return note_chord.tempo_ratio;
+    },
+    [](NoteChord &note_chord, const QVariant &value) {
+      return note_chord.maybeSetTempoRatio(value.toFloat());
+    }};
+
+constexpr ColumnDescriptor WORDS_DESCRIPTOR = {
+    "words", true,
+    [](const NoteChord &note_chord) -> QVariant { return note_chord.words; },
+    [](NoteChord &note_chord, const QVariant &value) {
+      note_chord.words = value.toString();
+      return true;
+    }};
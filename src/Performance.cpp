@@ -0,0 +1,166 @@
+#include "Performance.h"
+
+#include <numeric>
+#include <unordered_map>
+
+#include "ChordAudioCache.h"
+#include "InstrumentRegistry.h"
+
+Performance::Performance(const Song &song, const QModelIndex &first_index,
+                         int rows)
+    : key(static_cast<float>(song.frequency)),
+      current_volume((FULL_NOTE_VOLUME * static_cast<float>(song.volume_percent)) / PERCENT),
+      current_tempo(song.tempo) {
+  auto &item = song.const_node_from_index(first_index);
+  auto item_position = item.is_at_row();
+  auto end_position = item_position + rows;
+  auto &parent = item.get_parent();
+  parent.check_child_at(item_position);
+  parent.check_child_at(end_position - 1);
+  auto level = item.get_level();
+  if (level == 1) {
+    // skip to the state before the first chord in O(log n)
+    apply(song.get_chord_state(item_position));
+    for (auto index = item_position; index < end_position; index = index + 1) {
+      const auto &compiled_chord = song.get_compiled_chord(index);
+      modulate(compiled_chord);
+      plan_notes(compiled_chord, 0, compiled_chord.get_note_count());
+      segment_beats = segment_beats + compiled_chord.beats;
+    }
+  } else if (level == 2) {
+    auto parent_position = parent.is_at_row();
+    parent.get_parent().check_child_at(parent_position);
+    apply(song.get_chord_state(parent_position));
+    modulate(song.get_compiled_chord(parent_position));
+    plan_notes(song.get_compiled_chord(parent_position), item_position,
+               end_position);
+  } else {
+    TreeNode::error_level(level);
+  }
+  sort_by_start_time();
+  coalesce_voices();
+}
+
+void Performance::modulate(const CompiledChord &compiled_chord) {
+  key = key * compiled_chord.key_ratio;
+  current_volume = current_volume * compiled_chord.volume_ratio;
+  if (compiled_chord.tempo_ratio != 1.0F) {
+    // start a new segment at the old tempo's time
+    segment_start_time = get_current_time();
+    segment_beats = 0.0;
+    current_tempo = current_tempo * compiled_chord.tempo_ratio;
+  }
+}
+
+// leaves the time alone, because we start playing at 0
+void Performance::apply(const ChordTransform &chord_state) {
+  key = static_cast<float>(key * chord_state.key_ratio);
+  current_volume = static_cast<float>(current_volume * chord_state.volume_ratio);
+  current_tempo = current_tempo * chord_state.tempo_ratio;
+}
+
+auto Performance::get_beat_duration() const -> double {
+  return SECONDS_PER_MINUTE / current_tempo;
+}
+
+auto Performance::get_current_time() const -> double {
+  return segment_start_time + segment_beats * get_beat_duration();
+}
+
+void Performance::plan_notes(const CompiledChord &compiled_chord,
+                             int first_note, int end_note) {
+  auto beat_duration = get_beat_duration();
+  auto start_time = get_current_time();
+  for (auto note = first_note; note < end_note; note = note + 1) {
+    start_times.push_back(start_time);
+    frequencies.push_back(key * compiled_chord.note_key_ratios[note]);
+    amplitudes.push_back(current_volume * compiled_chord.note_volume_ratios[note]);
+    durations.push_back(beat_duration * compiled_chord.note_beats[note]);
+    instrument_ids.push_back(compiled_chord.note_instrument_ids[note]);
+  }
+}
+
+auto Performance::get_note_count() const -> int {
+  return static_cast<int>(start_times.size());
+}
+
+// chords can go back in time, but the engine needs notes in order
+void Performance::sort_by_start_time() {
+  if (std::is_sorted(start_times.begin(), start_times.end())) {
+    return;
+  }
+  std::vector<int> order(start_times.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](int first, int second) {
+    return start_times[first] < start_times[second];
+  });
+  auto reorder = [&order](auto &values) {
+    auto old_values = values;
+    for (size_t index = 0; index < order.size(); index = index + 1) {
+      values[index] = old_values[order[index]];
+    }
+  };
+  reorder(start_times);
+  reorder(frequencies);
+  reorder(amplitudes);
+  reorder(durations);
+  reorder(instrument_ids);
+}
+
+// notes that can play as one voice
+class VoiceKey {
+ public:
+  double start_time;
+  float frequency;
+  double duration;
+  int instrument_id;
+
+  [[nodiscard]] auto operator==(const VoiceKey &other) const -> bool = default;
+};
+
+class VoiceKeyHash {
+ public:
+  auto operator()(const VoiceKey &voice_key) const -> size_t {
+    auto hash = add_to_hash(HASH_START, voice_key.start_time);
+    hash = add_to_hash(hash, voice_key.frequency);
+    hash = add_to_hash(hash, voice_key.duration);
+    return add_to_hash(hash, voice_key.instrument_id);
+  }
+};
+
+// notes with the same start, frequency, duration and instrument only differ
+// in amplitude, so play them as one louder voice
+// only for linear instruments, where the sound doesn't change
+// one pass, looking up earlier notes by what they share
+void Performance::coalesce_voices() {
+  // ids are already resolved
+  auto linear_flags = InstrumentRegistry::get_registry().get_linear_flags();
+  auto note_count = get_note_count();
+  auto kept_count = 0;
+  std::unordered_map<VoiceKey, int, VoiceKeyHash> kept_positions;
+  kept_positions.reserve(note_count);
+  for (auto note = 0; note < note_count; note = note + 1) {
+    if (linear_flags[instrument_ids[note]]) {
+      auto [found, inserted] = kept_positions.try_emplace(
+          VoiceKey{start_times[note], frequencies[note], durations[note],
+                   instrument_ids[note]},
+          kept_count);
+      if (!inserted) {
+        auto kept = found->second;
+        amplitudes[kept] = amplitudes[kept] + amplitudes[note];
+        continue;
+      }
+    }
+    start_times[kept_count] = start_times[note];
+    frequencies[kept_count] = frequencies[note];
+    amplitudes[kept_count] = amplitudes[note];
+    durations[kept_count] = durations[note];
+    instrument_ids[kept_count] = instrument_ids[note];
+    kept_count = kept_count + 1;
+  }
+  start_times.resize(kept_count);
+  frequencies.resize(kept_count);
+  amplitudes.resize(kept_count);
+  durations.resize(kept_count);
+  instrument_ids.resize(kept_count);
+}
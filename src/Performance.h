@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Song.h"
+
+const auto PERCENT = 100;
+const auto SECONDS_PER_MINUTE = 60;
+const auto FULL_NOTE_VOLUME = 0.2F;
+
+// a flat snapshot of the notes to play, one array per field
+// build this on the gui thread so the player never touches the song
+// building only reads compiled chords, so it's cheap
+class Performance {
+ public:
+  float key = DEFAULT_FREQUENCY;
+  float current_volume = (1.0F * DEFAULT_VOLUME_PERCENT) / PERCENT;
+  // doubles, so long songs don't drift off their frames
+  double current_tempo = DEFAULT_TEMPO;
+  // time is exact beats since the last tempo change, so it only rounds
+  // once per tempo change, not once per chord
+  double segment_start_time = 0.0;
+  double segment_beats = 0.0;
+
+  std::vector<double> start_times;
+  std::vector<float> frequencies;
+  std::vector<float> amplitudes;
+  std::vector<double> durations;
+  std::vector<int> instrument_ids;
+
+  Performance() = default;
+  Performance(const Song &song, const QModelIndex &first_index, int rows);
+
+  void apply(const ChordTransform &chord_state);
+  void modulate(const CompiledChord &compiled_chord);
+  [[nodiscard]] auto get_beat_duration() const -> double;
+  [[nodiscard]] auto get_current_time() const -> double;
+  void plan_notes(const CompiledChord &compiled_chord, int first_note,
+                  int end_note);
+  [[nodiscard]] auto get_note_count() const -> int;
+  void sort_by_start_time();
+  void coalesce_voices();
+};
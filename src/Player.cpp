@@ -1,88 +1,210 @@
 #include "Player.h"
 
-Player::Player() { gam::sampleRate(audio_io.fps()); }
+Player::Player(QObject *parent) : QObject(parent) {
+  // parent the timer so it moves to the player thread with us
+  progress_timer.setParent(this);
+  progress_timer.setInterval(PROGRESS_MILLISECONDS);
+  connect(&progress_timer, &QTimer::timeout, this, &Player::update_progress);
+  render_pool.setMaxThreadCount(1);
+}
+
+Player::~Player() {
+  // exports signal us when they finish
+  render_pool.waitForDone();
+  stop_audio();
+  close_stream();
+}
 
-void Player::modulate(const TreeNode &node) {
-  const auto &note_chord_pointer = node.note_chord_pointer;
-  key = key * note_chord_pointer->get_ratio();
-  current_volume = current_volume * note_chord_pointer->volume_ratio;
-  current_tempo = current_tempo * note_chord_pointer->tempo_ratio;
+// follows the audio thread, so it keeps up with tempo changes
+auto Player::get_position() const -> float {
+  return seek_time +
+         static_cast<float>(
+             static_cast<double>(engine.current_frame.load() -
+                                 engine.feed_origin_frame) /
+             engine.frames_per_second);
 }
 
-auto Player::get_beat_duration() const -> float {
-  return SECONDS_PER_MINUTE / current_tempo;
+auto Player::get_frames_per_buffer() const -> int {
+  switch (latency_profile) {
+    case low_latency:
+      return LOW_LATENCY_FRAMES;
+    case balanced_latency:
+      return BALANCED_FRAMES;
+    case safe_latency:
+      return SAFE_FRAMES;
+    case automatic_latency:
+      return automatic_frames;
+  }
+  return BALANCED_FRAMES;
 }
 
-void Player::schedule_note(const TreeNode &node) {
-  auto *note_chord_pointer = node.note_chord_pointer.get();
-  auto instrument = note_chord_pointer->instrument;
-  if (!instrument_map.contains(instrument)) {
-    qInfo() << QString("Instrument %1 not defined; using the default instrument!").arg(instrument);
-    instrument = "default";
+// uses the stats from the last time we played
+void Player::tune_automatic_frames() {
+  const auto &stats = engine.stats;
+  if (latency_profile != automatic_latency || stats.callbacks.load() == 0) {
+    return;
   }
-  const auto *sound_pointer = instrument_map[instrument];
-  auto true_duration = sound_pointer->add(
-    scheduler,
-    current_time,
-    key * note_chord_pointer->get_ratio(),
-    current_volume * note_chord_pointer->volume_ratio,
-    get_beat_duration() * static_cast<float>(note_chord_pointer->beats)
-  );
-  auto final_time = current_time + true_duration;
-  if (final_time > total_time) {
-    total_time = final_time;
+  if (stats.xruns.load() > 0) {
+    failed_frames = std::max(failed_frames, automatic_frames);
+    automatic_frames = std::min(automatic_frames * 2, MAX_AUTOMATIC_FRAMES);
+  } else if (stats.get_max_load() < SHRINK_LOAD &&
+             automatic_frames / 2 > failed_frames &&
+             automatic_frames / 2 >= LOW_LATENCY_FRAMES) {
+    automatic_frames = automatic_frames / 2;
   }
 }
 
-void Player::play(const Song &song, const QModelIndex &first_index, int rows) {
-  // in case we ended early for some reason, empty first
-  key = static_cast<float>(song.frequency);
-  current_volume = (FULL_NOTE_VOLUME * static_cast<float>(song.volume_percent)) / PERCENT;
-  current_tempo = static_cast<float>(song.tempo);
-  current_time = (1.0F * TRANSITION_MILLISECONDS) / MILLISECONDS_PER_SECOND;
-  total_time = current_time;
-
-  auto &item = song.const_node_from_index(first_index);
-  auto item_position = item.is_at_row();
-  auto end_position = item_position + rows;
-  auto &parent = item.get_parent();
-  parent.check_child_at(item_position);
-  parent.check_child_at(end_position - 1);
-  auto &sibling_pointers = parent.child_pointers;
-  auto level = item.get_level();
-  if (level == 1) {
-    for (auto index = 0; index < end_position; index = index + 1) {
-      auto &sibling = *sibling_pointers[index];
-      modulate(sibling);
-      if (index >= item_position) {
-        for (const auto &nibling_pointer : sibling.child_pointers) {
-          schedule_note(*nibling_pointer);
-        }
-        current_time = current_time +
-                       get_beat_duration() * static_cast<float>(sibling.note_chord_pointer->beats);
-      }
-    }
-  } else if (level == 2) {
-    auto &grandparent = parent.get_parent();
-    auto &uncle_pointers = grandparent.child_pointers;
-    auto parent_position = parent.is_at_row();
-    grandparent.check_child_at(parent_position);
-    for (auto index = 0; index <= parent_position; index = index + 1) {
-      modulate(*uncle_pointers[index]);
-    }
-    for (auto index = item_position; index < end_position; index = index + 1) {
-      schedule_note(*sibling_pointers[index]);
-    }
-  } else {
-    TreeNode::error_level(level);
+// returns true if the stream was already running
+// reopens the device if the buffer size or sample rate changed
+auto Player::open_stream() -> bool {
+  auto frames_per_buffer = get_frames_per_buffer();
+  if (audio_io.framesPerBuffer() != frames_per_buffer ||
+      audio_io.fps() != engine.frames_per_second) {
+    close_stream();
+    // the device must be closed to change the buffer
+    audio_io.close();
+    audio_io.framesPerBuffer(frames_per_buffer);
+    audio_io.fps(engine.frames_per_second);
+  }
+  if (stream_open) {
+    return true;
   }
-  scheduler.start();
+  engine.stats.reset();
   audio_io.start();
-  QThread::msleep(
-      static_cast<int>(ceil((total_time + OVERLAP) * MILLISECONDS_PER_SECOND)) +
-      TRANSITION_MILLISECONDS*2);
-  audio_io.stop();
-  scheduler.stop();
-  scheduler.update();
-  scheduler.reclaim();
+  stream_open = true;
+  return false;
+}
+
+void Player::close_stream() {
+  if (stream_open) {
+    audio_io.stop();
+    // otherwise unfinished notes would sound next time
+    engine.clear();
+    stream_open = false;
+  }
+}
+
+void Player::stop_audio() {
+  if (playing) {
+    progress_timer.stop();
+    if (keep_stream_open) {
+      // keep rendering silence
+      engine.silence();
+    } else {
+      close_stream();
+    }
+    playing = false;
+  }
+}
+
+void Player::update_progress() {
+  engine.feed_ahead();
+  emit progress(get_position());
+  // grow the buffer as soon as we miss a deadline
+  if (latency_profile == automatic_latency && engine.stats.xruns.load() > 0 &&
+      automatic_frames < MAX_AUTOMATIC_FRAMES) {
+    seek(std::max(get_position(), 0.0F));
+    return;
+  }
+  auto played_time =
+      get_position() - seek_time +
+      (1.0 * lead_in_milliseconds) / MILLISECONDS_PER_SECOND;
+  // clips don't follow the tempo, so wait until they're done too
+  if (engine.held_clips.empty() &&
+      played_time >
+          end_time + OVERLAP +
+              // let the device play out before we close it
+              (stream_open && keep_stream_open
+                   ? 0.0
+                   : (1.0 * TRANSITION_MILLISECONDS) /
+                         MILLISECONDS_PER_SECOND)) {
+    stop();
+  }
+}
+
+void Player::play(Performance new_performance, float seconds) {
+  performance = std::move(new_performance);
+  seek(seconds);
+}
+
+void Player::seek(float seconds) {
+  stop_audio();
+  seek_time = seconds;
+  tune_automatic_frames();
+  // a running stream takes new notes at its next block
+  lead_in_milliseconds = open_stream() ? 0 : TRANSITION_MILLISECONDS;
+  end_time = engine.start_feeding(
+      performance, seek_time,
+      (1.0F * lead_in_milliseconds) / MILLISECONDS_PER_SECOND);
+  engine.feed_ahead();
+  progress_timer.start();
+  playing = true;
+}
+
+void Player::stop() {
+  if (playing) {
+    stop_audio();
+    emit finished();
+  }
+}
+
+void Player::set_latency_profile(LatencyProfile new_latency_profile) {
+  latency_profile = new_latency_profile;
+  // pick up the new buffer where we are
+  if (playing) {
+    seek(std::max(get_position(), 0.0F));
+  } else if (keep_stream_open) {
+    open_stream();
+  }
+}
+
+void Player::set_keep_stream_open(bool new_keep_stream_open) {
+  keep_stream_open = new_keep_stream_open;
+  if (keep_stream_open) {
+    // warm up now, so the first play is fast too
+    open_stream();
+  } else if (!playing) {
+    close_stream();
+  }
+}
+
+// notes already queued play the old way
+void Player::set_cache_chords(bool new_cache_chords) {
+  cache_chords = new_cache_chords;
+  engine.chord_cache_pointer = cache_chords ? &chord_cache : nullptr;
+}
+
+// makes new instruments, so stop first
+void Player::set_frames_per_second(double frames_per_second) {
+  stop();
+  close_stream();
+  if (frames_per_second == 0) {
+    frames_per_second = default_output.defaultSampleRate();
+  }
+  engine.set_frames_per_second(frames_per_second);
+  if (keep_stream_open) {
+    open_stream();
+  }
+}
+
+auto Player::render(const Performance &performance,
+                    const QString &file_name) const -> bool {
+  return render_to_file(performance, engine.frames_per_second, file_name,
+                        RenderWorkers::get_default_worker_count(),
+                        engine.chord_cache_pointer);
+}
+
+// reads the settings here, on the player thread, where they change
+// then renders on the pool, so neither the gui nor playback waits
+void Player::start_render(Performance performance, const QString &file_name) {
+  auto frames_per_second = engine.frames_per_second;
+  auto *chord_cache_pointer = engine.chord_cache_pointer;
+  render_pool.start([this, performance = std::move(performance), file_name,
+                     frames_per_second, chord_cache_pointer]() {
+    emit render_finished(
+        file_name,
+        render_to_file(performance, frames_per_second, file_name,
+                       RenderWorkers::get_default_worker_count(),
+                       chord_cache_pointer));
+  });
 }
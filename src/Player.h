@@ -1,42 +1,96 @@
 #pragma once
 
+#include <QObject>
 #include <QString>
-#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
 
-#include "Song.h"
-#include "Instrument.h"
+#include "Render.h"
 
-const auto PERCENT = 100;
-const auto FRAMES_PER_BUFFER = 256;
-const auto SECONDS_PER_MINUTE = 60;
+const auto LOW_LATENCY_FRAMES = 64;
+const auto BALANCED_FRAMES = 256;
+const auto SAFE_FRAMES = 1024;
+const auto MAX_AUTOMATIC_FRAMES = 4096;
+// only shrink the buffer if the busiest callback used less than this
+const auto SHRINK_LOAD = 0.25;
 const auto TRANSITION_MILLISECONDS = 100;
-const auto MILLISECONDS_PER_SECOND = 1000;
-const auto FULL_NOTE_VOLUME = 0.2F;
+const auto PROGRESS_MILLISECONDS = 50;
 
-const DefaultInstrument DUMMY(0.0, 0.0, 0.0, 1.0);
+enum LatencyProfile {
+  low_latency,
+  balanced_latency,
+  safe_latency,
+  // pick the smallest buffer that doesn't miss deadlines on this machine
+  automatic_latency,
+};
 
-class Player {
+// lives on its own thread, so slots never block the gui
+class Player : public QObject {
+  Q_OBJECT
  public:
-  float key = DEFAULT_FREQUENCY;
-  float current_volume = (1.0F * DEFAULT_VOLUME_PERCENT) / PERCENT;
-  float current_tempo = DEFAULT_TEMPO;
-  float current_time = 0.0;
-  float total_time = current_time;
-
-  std::map<const QString, const Instrument *> instrument_map =
-      std::map<const QString, const Instrument *>{{"default", (const Instrument *)&DUMMY}};
-
-  gam::Scheduler scheduler;
   gam::AudioDevice default_output =
       gam::AudioDevice(gam::AudioDevice::defaultOutput());
+  // shared by playback and renders, so replaying skips unchanged chords
+  // only used if we cache chords
+  mutable ChordAudioCache chord_cache;
+  Engine engine = Engine(default_output.defaultSampleRate());
   gam::AudioIO audio_io =
-      gam::AudioIO(FRAMES_PER_BUFFER, default_output.defaultSampleRate(),
-                   gam::Scheduler::audioCB, &scheduler, 2, 0);
+      gam::AudioIO(BALANCED_FRAMES, engine.frames_per_second,
+                   Engine::audio_callback, &engine, OUTPUT_CHANNELS, 0);
+  LatencyProfile latency_profile = balanced_latency;
+  int automatic_frames = LOW_LATENCY_FRAMES;
+  // the largest buffer that missed a deadline in automatic mode
+  int failed_frames = 0;
+
+  // keep the device running between plays, so we start within a buffer
+  bool keep_stream_open = false;
+  bool stream_open = false;
+  // play chords we rendered before instead of voices
+  // faster to replay, but chords we already rendered don't follow the tempo,
+  // and clips don't use polyphony limits or the workers
+  bool cache_chords = false;
+  // silence before the notes, while the device starts
+  int lead_in_milliseconds = TRANSITION_MILLISECONDS;
+
+  Performance performance;
+  bool playing = false;
+  // seconds into the performance where the audio started
+  float seek_time = 0.0;
+  double end_time = 0.0;
+  QTimer progress_timer;
+  // one export at a time, each with its own workers
+  QThreadPool render_pool;
+
+  explicit Player(QObject *parent = nullptr);
+  ~Player() override;
+  Player(const Player &other) = delete;
+  auto operator=(const Player &other) -> Player & = delete;
+  Player(Player &&other) = delete;
+  auto operator=(Player &&other) -> Player & = delete;
+
+  [[nodiscard]] auto get_position() const -> float;
+  [[nodiscard]] auto get_frames_per_buffer() const -> int;
+  void tune_automatic_frames();
+  auto open_stream() -> bool;
+  void close_stream();
+  void stop_audio();
+  void update_progress();
+  // only on the player thread, or while it's idle
+  auto render(const Performance &performance, const QString &file_name) const
+      -> bool;
+  void start_render(Performance performance, const QString &file_name);
 
-  Player();
+  void play(Performance new_performance, float seconds = 0.0F);
+  void seek(float seconds);
+  void stop();
+  void set_latency_profile(LatencyProfile new_latency_profile);
+  void set_keep_stream_open(bool new_keep_stream_open);
+  void set_cache_chords(bool new_cache_chords);
+  // 0 for the device default
+  void set_frames_per_second(double frames_per_second);
 
-  void modulate(const TreeNode &node);
-  [[nodiscard]] auto get_beat_duration() const -> float;
-  void schedule_note(const TreeNode &node);
-  void play(const Song &song, const QModelIndex &first_index, int rows);
+ signals:
+  void progress(float seconds);
+  void finished();
+  void render_finished(const QString &file_name, bool succeeded);
 };
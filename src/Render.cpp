@@ -0,0 +1,45 @@
+#include "Render.h"
+
+#include "Gamma/SoundFile.h"
+
+auto render_to_file(const Performance &performance, double frames_per_second,
+                    const QString &file_name, int worker_count,
+                    ChordAudioCache *chord_cache_pointer) -> bool {
+  Engine offline_engine(frames_per_second);
+  offline_engine.set_worker_count(worker_count);
+  offline_engine.chord_cache_pointer = chord_cache_pointer;
+  // no lead-in silence needed when there is no device to open
+  auto total_time = offline_engine.start_feeding(performance, 0.0F, 0.0F);
+  gam::SoundFile sound_file(file_name.toStdString());
+  sound_file.format(file_name.endsWith(".flac", Qt::CaseInsensitive)
+                        ? gam::SoundFile::FLAC
+                        : gam::SoundFile::WAV);
+  sound_file.encoding(gam::SoundFile::PCM_24);
+  sound_file.channels(OUTPUT_CHANNELS);
+  sound_file.frameRate(frames_per_second);
+  if (!sound_file.openWrite()) {
+    qCritical("Cannot write to %s!", qUtf8Printable(file_name));
+    return false;
+  }
+  auto total_frames =
+      static_cast<int>(ceil((total_time + OVERLAP) * frames_per_second));
+  // write as we go, so memory doesn't grow with the song
+  std::vector<float> left_samples(RENDER_FRAMES);
+  std::vector<float> right_samples(RENDER_FRAMES);
+  std::vector<float> samples(RENDER_FRAMES * OUTPUT_CHANNELS);
+  for (auto first_frame = 0; first_frame < total_frames;
+       first_frame = first_frame + RENDER_FRAMES) {
+    auto frames = std::min(RENDER_FRAMES, total_frames - first_frame);
+    std::fill(left_samples.begin(), left_samples.end(), 0.0F);
+    std::fill(right_samples.begin(), right_samples.end(), 0.0F);
+    offline_engine.feed_and_render(left_samples.data(), right_samples.data(),
+                                   frames);
+    for (auto frame = 0; frame < frames; frame = frame + 1) {
+      samples[frame * OUTPUT_CHANNELS] = left_samples[frame];
+      samples[frame * OUTPUT_CHANNELS + 1] = right_samples[frame];
+    }
+    sound_file.write(samples.data(), frames);
+  }
+  sound_file.close();
+  return true;
+}
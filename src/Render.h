@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QString>
+
+#include "Engine.h"
+
+const auto OUTPUT_CHANNELS = 2;
+const auto RENDER_FRAMES = 4096;
+const auto MILLISECONDS_PER_SECOND = 1000;
+
+// run the same engine as play, but without a device or sleeping
+// uses its own engine, so we can render while playing, or many at once
+// pass a cache to reuse chords we rendered before
+auto render_to_file(const Performance &performance, double frames_per_second,
+                    const QString &file_name,
+                    int worker_count = RenderWorkers::get_default_worker_count(),
+                    ChordAudioCache *chord_cache_pointer = nullptr) -> bool;
@@ -0,0 +1,82 @@
+#include "RenderWorkers.h"
+
+RenderWorkers::RenderWorkers(int worker_count)
+    : partial_blocks(worker_count + 1), scratch_blocks(worker_count + 1) {
+  for (auto share = 1; share <= worker_count; share = share + 1) {
+    threads.emplace_back(&RenderWorkers::work, this, share);
+  }
+}
+
+RenderWorkers::~RenderWorkers() {
+  stopping = true;
+  generation.fetch_add(1);
+  generation.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+// leave a core for the gui and one for the audio thread
+auto RenderWorkers::get_default_worker_count() -> int {
+  return std::clamp(static_cast<int>(std::thread::hardware_concurrency()) - 2,
+                    0, MAX_RENDER_WORKERS);
+}
+
+auto RenderWorkers::get_share_count() const -> int {
+  return static_cast<int>(partial_blocks.size());
+}
+
+// each share gets a contiguous run of voices
+void RenderWorkers::render_share(int share, int frames) {
+  auto share_count = get_share_count();
+  auto voice_count = static_cast<int>(active_voice_pointers.size());
+  auto &partial_block = partial_blocks[share];
+  std::fill(partial_block.begin(), partial_block.begin() + frames, 0.0F);
+  for (auto index = share * voice_count / share_count;
+       index < (share + 1) * voice_count / share_count; index = index + 1) {
+    active_voice_pointers[index]->render(partial_block.data(),
+                                         scratch_blocks[share].data(), frames);
+  }
+}
+
+void RenderWorkers::work(int share) {
+  auto seen_generation = 0;
+  while (true) {
+    generation.wait(seen_generation);
+    seen_generation = generation.load();
+    if (stopping) {
+      return;
+    }
+    render_share(share, block_frames);
+    if (remaining.fetch_sub(1) == 1) {
+      remaining.notify_one();
+    }
+  }
+}
+
+void RenderWorkers::render(float *bus_pointer, int frames) {
+  auto voice_count = static_cast<int>(active_voice_pointers.size());
+  if (threads.empty() ||
+      voice_count < MIN_VOICES_PER_THREAD * get_share_count()) {
+    for (auto *voice_pointer : active_voice_pointers) {
+      voice_pointer->render(bus_pointer, scratch_blocks[0].data(), frames);
+    }
+    return;
+  }
+  block_frames = frames;
+  remaining = static_cast<int>(threads.size());
+  generation.fetch_add(1);
+  generation.notify_all();
+  // do our share while the workers do theirs
+  render_share(0, frames);
+  auto still_working = remaining.load();
+  while (still_working > 0) {
+    remaining.wait(still_working);
+    still_working = remaining.load();
+  }
+  for (const auto &partial_block : partial_blocks) {
+    for (auto frame = 0; frame < frames; frame = frame + 1) {
+      bus_pointer[frame] += partial_block[frame];
+    }
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "VoicePool.h"
+
+// below this many voices per thread, waking threads costs more than it saves
+const auto MIN_VOICES_PER_THREAD = 8;
+const auto MAX_RENDER_WORKERS = 3;
+
+// renders the active voices of a block on a few threads
+// each thread sums into its own partial bus, and we add the partial buses
+// in a fixed order, so the output doesn't depend on thread timing
+class RenderWorkers {
+ public:
+  std::vector<std::thread> threads;
+  // share 0 is for the calling thread, the rest are for the workers
+  std::vector<std::array<float, MAX_BLOCK_FRAMES>> partial_blocks;
+  std::vector<std::array<float, MAX_BLOCK_FRAMES>> scratch_blocks;
+  // filled before each block; reserve, so filling doesn't allocate
+  std::vector<Voice *> active_voice_pointers;
+  int block_frames = 0;
+  std::atomic<int> generation = 0;
+  std::atomic<int> remaining = 0;
+  std::atomic<bool> stopping = false;
+
+  explicit RenderWorkers(int worker_count = get_default_worker_count());
+  ~RenderWorkers();
+  RenderWorkers(const RenderWorkers &other) = delete;
+  auto operator=(const RenderWorkers &other) -> RenderWorkers & = delete;
+  RenderWorkers(RenderWorkers &&other) = delete;
+  auto operator=(RenderWorkers &&other) -> RenderWorkers & = delete;
+
+  [[nodiscard]] static auto get_default_worker_count() -> int;
+  [[nodiscard]] auto get_share_count() const -> int;
+  void render_share(int share, int frames);
+  void work(int share);
+  // add the active voices to the mono bus
+  void render(float *bus_pointer, int frames);
+};
@@ -1,17 +1,29 @@
 #include "Song.h"
 
+#include "InstrumentRegistry.h"
+
 // functions not ending with _directly set up undo/redo commands
 // functions ending with _directly are called by undo/redo
 
 Song::Song(QObject *parent)
-    : QAbstractItemModel(parent) { }
+    : QAbstractItemModel(parent), root(nullptr, &node_arena) { }
 
 void Song::load(const QJsonObject &json_object) {
+  // warn about missing instruments again
+  InstrumentRegistry::get_registry().start_song();
   setFrequency(json_object["frequency"].toInt());
   setVolumePercent(json_object["volume_percent"].toInt());
   setTempo(json_object["tempo"].toInt());
   if (json_object.contains("children")) {
-    root.insertRows(0, json_object["children"].toArray());
+    const auto &json_children = json_object["children"].toArray();
+    auto rows = static_cast<int>(json_children.size());
+    if (rows > 0) {
+      // one signal for the whole song
+      beginInsertRows(QModelIndex(), 0, rows - 1);
+      root.insertRows(0, json_children);
+      invalidate_rows_inserted(0, rows, QModelIndex());
+      endInsertRows();
+    }
   }
 }
 
@@ -89,6 +101,7 @@ auto Song::setData_directly(const QModelIndex &index, const QVariant &value,
                             int role) -> bool {
   auto was_set = node_from_index(index).setData(index.column(), value, role);
   if (was_set) {
+    invalidate_chord(index);
     emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
   }
   return was_set;
@@ -105,6 +118,7 @@ auto Song::removeRows(int position, int rows, const QModelIndex &parent_index)
     -> bool {
   beginRemoveRows(parent_index, position, position + rows - 1);
   node_from_index(parent_index).removeRows(position, rows);
+  invalidate_rows_removed(position, rows, parent_index);
   endRemoveRows();
   return true;
 };
@@ -116,6 +130,7 @@ auto Song::remove_save(int position, size_t rows, const QModelIndex &parent_inde
     -> void {
   beginRemoveRows(parent_index, position, position + static_cast<int>(rows) - 1);
   node_from_index(parent_index).removeRows(position, rows, deleted_rows);
+  invalidate_rows_removed(position, static_cast<int>(rows), parent_index);
   endRemoveRows();
 }
 
@@ -124,6 +139,7 @@ auto Song::insertRows(int position, int rows, const QModelIndex &parent_index)
   beginInsertRows(parent_index, position, position + rows - 1);
   // will error if invalid
   node_from_index(parent_index).insertRows(position, rows);
+  invalidate_rows_inserted(position, rows, parent_index);
   endInsertRows();
   return true;
 };
@@ -133,8 +149,10 @@ auto Song::insert_children(int position,
                            const QModelIndex &parent_index) -> void {
   beginInsertRows(parent_index, position,
                   position + static_cast<int>(insertion.size()) - 1);
+  auto rows = static_cast<int>(insertion.size());
   // will error if invalid
   node_from_index(parent_index).insertRows(position, insertion);
+  invalidate_rows_inserted(position, rows, parent_index);
   endInsertRows();
 };
 
@@ -145,6 +163,92 @@ auto Song::copy(const QModelIndex &first_index, size_t rows,
       .copy(first_index.row(), rows, copied);
 }
 
+auto Song::get_compiled_chord(int chord_position) const
+    -> const CompiledChord & {
+  auto &compiled_chord = compiled_chords[chord_position];
+  // new factories change what instruments resolve to
+  if (!compiled_chord.compiled ||
+      compiled_chord.factory_generation !=
+          InstrumentRegistry::get_registry().factory_generation.load()) {
+    compiled_chord.compile(root.get_child(chord_position));
+  }
+  return compiled_chord;
+}
+
+// the combined transform of the chords before chord_position
+auto Song::get_chord_state(int chord_position) const -> ChordTransform {
+  if (chord_states_stale) {
+    auto chord_count = static_cast<int>(compiled_chords.size());
+    chord_state_tree.resize(chord_count);
+    for (auto position = 0; position < chord_count; position = position + 1) {
+      chord_state_tree.set_leaf(position,
+                                ChordTransform(get_compiled_chord(position)));
+    }
+    chord_state_tree.build();
+    chord_states_stale = false;
+  } else {
+    for (auto position : edited_chord_positions) {
+      chord_state_tree.update(position,
+                              ChordTransform(get_compiled_chord(position)));
+    }
+  }
+  edited_chord_positions.clear();
+  return chord_state_tree.get_prefix(chord_position);
+}
+
+// edited positions would be out of date, and we rebuild everything anyway
+auto Song::mark_chord_states_stale() const -> void {
+  chord_states_stale = true;
+  edited_chord_positions.clear();
+}
+
+// recompile the chord the index is in next time we play
+auto Song::invalidate_chord(const QModelIndex &index) -> void {
+  auto level = const_node_from_index(index).get_level();
+  auto chord_position = 0;
+  if (level == 1) {
+    chord_position = index.row();
+  } else if (level == 2) {
+    chord_position = index.parent().row();
+  } else {
+    TreeNode::error_level(level);
+    return;
+  }
+  compiled_chords[chord_position].compiled = false;
+  if (!chord_states_stale) {
+    // past one edit per chord, rebuilding is as cheap as updating
+    if (edited_chord_positions.size() >= compiled_chords.size()) {
+      mark_chord_states_stale();
+    } else {
+      edited_chord_positions.push_back(chord_position);
+    }
+  }
+}
+
+auto Song::invalidate_rows_inserted(int position, int rows,
+                                    const QModelIndex &parent_index) -> void {
+  if (parent_index.isValid()) {
+    // new notes
+    invalidate_chord(parent_index);
+  } else {
+    // new chords
+    compiled_chords.insert(compiled_chords.begin() + position, rows,
+                           CompiledChord());
+    mark_chord_states_stale();
+  }
+}
+
+auto Song::invalidate_rows_removed(int position, int rows,
+                                   const QModelIndex &parent_index) -> void {
+  if (parent_index.isValid()) {
+    invalidate_chord(parent_index);
+  } else {
+    compiled_chords.erase(compiled_chords.begin() + position,
+                          compiled_chords.begin() + position + rows);
+    mark_chord_states_stale();
+  }
+}
+
 auto Song::setFrequency(int value, bool send_signal) -> void {
   if (send_signal) {
     emit frequency_changed(value);
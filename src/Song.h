@@ -2,15 +2,14 @@
 
 #include <QAbstractItemModel>
 
-#include "TreeNode.h"
+#include "ChordStateTree.h"
+#include "CompiledChord.h"
 #include "DefaultInstrument.h"
 
 const int DEFAULT_FREQUENCY = 220;
 const int DEFAULT_VOLUME_PERCENT = 50;
 const int DEFAULT_TEMPO = 200;
 
-const int NOTE_CHORD_COLUMNS = 9;
-
 class Song : public QAbstractItemModel {
   Q_OBJECT
 
@@ -19,8 +18,19 @@ class Song : public QAbstractItemModel {
   int volume_percent = DEFAULT_VOLUME_PERCENT;
   int tempo = DEFAULT_TEMPO;
   
+  // before root, so it outlives the nodes in it
+  NodeArena node_arena;
   // pointer so the pointer, but not object, can be constant
   TreeNode root;
+  // one for each chord, compiled lazily when we play
+  mutable std::vector<CompiledChord> compiled_chords;
+  // the state before each chord, updated lazily when we play
+  mutable ChordStateTree chord_state_tree;
+  // rebuild after chords are inserted or removed
+  mutable bool chord_states_stale = true;
+  // otherwise, just update chords that were edited
+  // never more than there are chords
+  mutable std::vector<int> edited_chord_positions;
 
   explicit Song(QObject *parent = nullptr);
   void load(const QJsonObject &json_object);
@@ -57,6 +67,16 @@ class Song : public QAbstractItemModel {
       -> void;
   auto copy(const QModelIndex &first_index, size_t rows,
             std::vector<std::unique_ptr<TreeNode>> &copied) const -> void;
+  [[nodiscard]] auto get_compiled_chord(int chord_position) const
+      -> const CompiledChord &;
+  [[nodiscard]] auto get_chord_state(int chord_position) const
+      -> ChordTransform;
+  auto mark_chord_states_stale() const -> void;
+  auto invalidate_chord(const QModelIndex &index) -> void;
+  auto invalidate_rows_inserted(int position, int rows,
+                                const QModelIndex &parent_index) -> void;
+  auto invalidate_rows_removed(int position, int rows,
+                               const QModelIndex &parent_index) -> void;
   auto setFrequency(int value, bool send_signal = true) -> void;
   auto setVolumePercent(int value, bool send_signal = true) -> void;
   auto setTempo(int value, bool send_signal = true) -> void;
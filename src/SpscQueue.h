@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+
+// a fixed size ring for one producer thread and one consumer thread
+// never locks or allocates after construction
+template <typename Item>
+class SpscQueue {
+ public:
+  std::vector<Item> items;
+  const size_t mask;
+  std::atomic<size_t> read_index = 0;
+  std::atomic<size_t> write_index = 0;
+
+  // capacity must be a power of 2
+  explicit SpscQueue(size_t capacity) : items(capacity), mask(capacity - 1) {
+    if ((capacity & mask) != 0) {
+      qCritical("Capacity %zu is not a power of 2!", capacity);
+    }
+  }
+
+  // producer only; false if full
+  auto push(const Item &item) -> bool {
+    auto write_position = write_index.load(std::memory_order_relaxed);
+    if (write_position - read_index.load(std::memory_order_acquire) >
+        mask) {
+      return false;
+    }
+    items[write_position & mask] = item;
+    write_index.store(write_position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // consumer only; null if empty
+  auto get_front() -> Item * {
+    auto read_position = read_index.load(std::memory_order_relaxed);
+    if (read_position == write_index.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &items[read_position & mask];
+  }
+
+  // consumer only; call after get_front
+  void pop() {
+    read_index.store(read_index.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+  }
+
+  // only while neither thread is using the queue
+  void clear() {
+    read_index = 0;
+    write_index = 0;
+  }
+};
@@ -10,9 +10,154 @@ void TestEverything::test_everything() {
   QCOMPARE(first_chord_node.get_child_count(), 3);
   auto &first_note_node = first_chord_node.get_child(0);
   first_note_node.note_chord_pointer -> test();
+  // a loaded song is laid out in order: a chord, its data, then its notes
+  const auto *first_chord_address = reinterpret_cast<const std::byte *>(&first_chord_node);
+  const auto *first_chord_data_address = reinterpret_cast<const std::byte *>(
+      first_chord_node.note_chord_pointer.get());
+  const auto *first_note_address = reinterpret_cast<const std::byte *>(&first_note_node);
+  QVERIFY(first_chord_address < first_chord_data_address);
+  QVERIFY(first_chord_data_address < first_note_address);
+  // with nothing else between notes
+  const auto note_stride =
+      reinterpret_cast<const std::byte *>(&first_chord_node.get_child(1)) -
+      first_note_address;
+  QVERIFY(note_stride > 0);
+  QCOMPARE(reinterpret_cast<const std::byte *>(&first_chord_node.get_child(2)) -
+               first_note_address,
+           2 * note_stride);
   auto first_chord_index = song.index(0, 0);
   auto first_note_index = song.index(0, 0, first_chord_index);
   song.copy(first_chord_index, 3, editor.copied);
+
+  QTemporaryDir render_folder;
+  QVERIFY(editor.play_state.render(Performance(song, first_chord_index, 3),
+                                   render_folder.filePath("simple.wav")));
+  QVERIFY(QFile::exists(render_folder.filePath("simple.wav")));
+
+  // pastes share data with the clipboard until they're edited
+  editor.paste(3, QModelIndex());
+  editor.paste(3, QModelIndex());
+  QCOMPARE(song.rowCount(), 9);
+  QCOMPARE(song.root.get_child(6).note_chord_pointer,
+           editor.copied[0]->note_chord_pointer);
+  auto pasted_numerator_index = song.index(6, numerator_column);
+  QVERIFY(song.setData_directly(pasted_numerator_index, 3, Qt::EditRole));
+  QVERIFY(song.root.get_child(6).note_chord_pointer !=
+          editor.copied[0]->note_chord_pointer);
+  QCOMPARE(editor.copied[0]->note_chord_pointer->numerator,
+           song.root.get_child(0).note_chord_pointer->numerator);
+  editor.undo_stack.undo();
+  editor.undo_stack.undo();
+  QCOMPARE(song.rowCount(), 3);
+
+  QVERIFY(song.compiled_chords[0].compiled);
+  auto first_note_numerator_index = song.index(0, numerator_column, first_chord_index);
+  auto old_numerator = song.data(first_note_numerator_index, Qt::DisplayRole);
+  QVERIFY(song.setData_directly(first_note_numerator_index, 2, Qt::EditRole));
+  // editing a note only invalidates its chord
+  QVERIFY(!song.compiled_chords[0].compiled);
+  QVERIFY(song.compiled_chords[1].compiled);
+  QCOMPARE(song.get_compiled_chord(0).note_key_ratios[0], 2.0F);
+  song.setData_directly(first_note_numerator_index, old_numerator, Qt::EditRole);
+  // registering a missing instrument applies without editing the notes
+  auto &registry = InstrumentRegistry::get_registry();
+  auto first_note_instrument_index = song.index(0, instrument_column, first_chord_index);
+  auto old_instrument = song.data(first_note_instrument_index, Qt::DisplayRole);
+  QVERIFY(song.setData_directly(first_note_instrument_index, "Test Marimba",
+                                Qt::EditRole));
+  QCOMPARE(song.get_compiled_chord(0).note_instrument_ids[0], DEFAULT_INSTRUMENT_ID);
+  registry.register_factory("Test Marimba", [](const AudioContext &context) {
+    return std::make_unique<DefaultInstrument>(context);
+  });
+  QCOMPARE(song.get_compiled_chord(0).note_instrument_ids[0],
+           registry.intern("Test Marimba"));
+  song.setData_directly(first_note_instrument_index, old_instrument, Qt::EditRole);
+  // the cached state matches modulating through every chord before
+  auto chord_state = song.get_chord_state(2);
+  QVERIFY(qFuzzyCompare(chord_state.key_ratio,
+                        1.0 * song.get_compiled_chord(0).key_ratio *
+                            song.get_compiled_chord(1).key_ratio));
+  QVERIFY(qFuzzyCompare(chord_state.tempo_ratio,
+                        1.0 * song.get_compiled_chord(0).tempo_ratio *
+                            song.get_compiled_chord(1).tempo_ratio));
+
+  // a unison plays as one louder voice
+  Performance unison;
+  for (auto note = 0; note < 2; note = note + 1) {
+    unison.start_times.push_back(0.0);
+    unison.frequencies.push_back(DEFAULT_FREQUENCY);
+    unison.amplitudes.push_back(0.1F);
+    unison.durations.push_back(1.0);
+    unison.instrument_ids.push_back(DEFAULT_INSTRUMENT_ID);
+  }
+  unison.coalesce_voices();
+  QCOMPARE(unison.get_note_count(), 1);
+  QCOMPARE(unison.amplitudes[0], 0.2F);
+  // but not on an instrument that isn't linear
+  Performance marimba_unison;
+  for (auto note = 0; note < 2; note = note + 1) {
+    marimba_unison.start_times.push_back(0.0);
+    marimba_unison.frequencies.push_back(DEFAULT_FREQUENCY);
+    marimba_unison.amplitudes.push_back(0.1F);
+    marimba_unison.durations.push_back(1.0);
+    marimba_unison.instrument_ids.push_back(registry.intern("Test Marimba"));
+  }
+  marimba_unison.coalesce_voices();
+  QCOMPARE(marimba_unison.get_note_count(), 2);
+
+  // missing fields keep their defaults, and invalid ones are reported
+  Note loaded_note;
+  QJsonObject json_note;
+  json_note["numerator"] = 3;
+  json_note["denominator"] = -1;
+  QTest::ignoreMessage(QtCriticalMsg, "Invalid denominator!");
+  loaded_note.from_json(json_note);
+  QCOMPARE(loaded_note.numerator, 3);
+  QCOMPARE(loaded_note.denominator, DEFAULT_DENOMINATOR);
+  QCOMPARE(loaded_note.beats, DEFAULT_BEATS);
+  QCOMPARE(loaded_note.instrument, QString("default"));
+
+  // rows inserted in bulk still know where they are
+  TreeNode scratch_root;
+  scratch_root.insertRows(0, 4);
+  QCOMPARE(scratch_root.get_child_count(), static_cast<size_t>(4));
+  QCOMPARE(scratch_root.get_child(3).is_at_row(), 3);
+
+  VoicePool voice_pool(DefaultInstrument(*editor.play_state.engine.context_pointer), 2,
+                       steal_oldest);
+  voice_pool.start_voice(0, 0, DEFAULT_FREQUENCY, 1.0F, MIN_DURATION);
+  voice_pool.start_voice(1, 0, DEFAULT_FREQUENCY, 1.0F, MIN_DURATION);
+  voice_pool.start_voice(2, 0, DEFAULT_FREQUENCY, 1.0F, MIN_DURATION);
+  QCOMPARE(voice_pool.get_active_count(), 2);
+  // the oldest voice was stolen
+  QCOMPARE(voice_pool.voices[0].start_frame, static_cast<int64_t>(2));
+
+  // offline renders count blocks, but have no deadlines to miss
+  Engine offline_engine(editor.play_state.engine.frames_per_second);
+  Performance offline_performance(song, first_chord_index, 3);
+  auto offline_time = offline_engine.start_feeding(offline_performance, 0.0, 0.0);
+  auto offline_frames = static_cast<int>(
+      ceil((offline_time + OVERLAP) * offline_engine.frames_per_second));
+  std::vector<float> left_samples(offline_frames);
+  std::vector<float> right_samples(offline_frames);
+  offline_engine.feed_and_render(left_samples.data(), right_samples.data(),
+                                 offline_frames);
+  QVERIFY(offline_engine.stats.callbacks.load() > 0);
+  QCOMPARE(offline_engine.stats.xruns.load(), static_cast<int64_t>(0));
+
+  // cached chords only match the exact same notes
+  ChordAudioCache chord_cache;
+  ChordKey first_key;
+  first_key.frames_per_second = offline_engine.frames_per_second;
+  first_key.instrument_ids.push_back(DEFAULT_INSTRUMENT_ID);
+  first_key.frequencies.push_back(DEFAULT_FREQUENCY);
+  first_key.amplitudes.push_back(0.1F);
+  first_key.end_frames.push_back(1);
+  auto second_key = first_key;
+  second_key.amplitudes[0] = 0.2F;
+  chord_cache.add(first_key, std::make_shared<const std::vector<float>>(1, 0.0F));
+  QVERIFY(chord_cache.get(first_key) != nullptr);
+  QVERIFY(chord_cache.get(second_key) == nullptr);
   
   
   editor.save("C:/Users/brand/Justly/examples/simple.json");
@@ -2,7 +2,7 @@
 
 void TreeNode::error_level(int level) { qCritical("Invalid level %d!", level); }
 
-auto TreeNode::new_child_note_chord_pointer(TreeNode *parent_pointer) -> std::unique_ptr<NoteChord> {
+auto TreeNode::new_child_note_chord_pointer(TreeNode *parent_pointer) -> std::shared_ptr<NoteChord> {
   // if parent is null, this is the root
   // the root will have no data
   if (parent_pointer == nullptr) {
@@ -11,43 +11,68 @@ auto TreeNode::new_child_note_chord_pointer(TreeNode *parent_pointer) -> std::un
   return parent_pointer -> new_child_note_chord_pointer();
 }
 
-auto TreeNode::new_child_note_chord_pointer() -> std::unique_ptr<NoteChord> {
+auto TreeNode::new_child_note_chord_pointer() const -> std::shared_ptr<NoteChord> {
   // the root will have no item
   // root children are chords
+  // called while we're constructed, so our data goes right after us
   if (note_chord_pointer == nullptr) {
-    return std::make_unique<Chord>();
+    return make_shared_in<Chord>(arena_pointer);
   }
-  return note_chord_pointer -> new_child_note_chord_pointer();
+  return note_chord_pointer -> new_child_note_chord_pointer(arena_pointer);
 }
 
-TreeNode::TreeNode(TreeNode *parent_pointer_input)
-    : parent_pointer(parent_pointer_input),
-      note_chord_pointer(TreeNode::new_child_note_chord_pointer(parent_pointer_input)){};
+auto TreeNode::new_child() -> std::unique_ptr<TreeNode> {
+  return std::unique_ptr<TreeNode>(new (arena_pointer) TreeNode(this));
+}
 
+auto TreeNode::operator new(size_t size) -> void * {
+  return NodeArena::allocate_in(nullptr, size);
+}
 
-auto TreeNode::copy_note_chord_pointer() const -> std::unique_ptr<NoteChord> {
-  if (note_chord_pointer == nullptr) {
-    return nullptr;
-  }
-  return note_chord_pointer -> pointer_copy_self();
+auto TreeNode::operator new(size_t size, NodeArena *arena_pointer) -> void * {
+  return NodeArena::allocate_in(arena_pointer, size);
+}
+
+void TreeNode::operator delete(void *pointer) {
+  NodeArena::deallocate_from(pointer);
 }
 
+// only called if a constructor throws
+void TreeNode::operator delete(void *pointer, NodeArena * /*arena_pointer*/) {
+  NodeArena::deallocate_from(pointer);
+}
+
+TreeNode::TreeNode(TreeNode *parent_pointer_input, NodeArena *arena_pointer_input)
+    : parent_pointer(parent_pointer_input),
+      arena_pointer(parent_pointer_input == nullptr
+                        ? arena_pointer_input
+                        : parent_pointer_input->arena_pointer),
+      note_chord_pointer(TreeNode::new_child_note_chord_pointer(parent_pointer_input)){};
+
+
 void TreeNode::copy_children(TreeNode &copied) {
+  child_pointers.reserve(copied.child_pointers.size());
   for (int index = 0; index < copied.child_pointers.size(); index = index + 1) {
-    child_pointers.push_back(std::make_unique<TreeNode>(
-        *(copied.child_pointers[index]), this));
+    child_pointers.push_back(std::unique_ptr<TreeNode>(
+        new (arena_pointer) TreeNode(*(copied.child_pointers[index]), this)));
   }
+  renumber_children(0);
 }
 
+// copies share data, so we only copy the tree structure
 TreeNode::TreeNode(TreeNode &copied, TreeNode *parent_pointer_input)
     : parent_pointer(parent_pointer_input),
-      note_chord_pointer(copied.copy_note_chord_pointer()) {
+      arena_pointer(parent_pointer_input == nullptr
+                        ? copied.arena_pointer
+                        : parent_pointer_input->arena_pointer),
+      note_chord_pointer(copied.note_chord_pointer) {
   copy_children(copied);
 }
 
 TreeNode::TreeNode(TreeNode &copied)
     : parent_pointer(copied.parent_pointer),
-      note_chord_pointer(copied.copy_note_chord_pointer()) {
+      arena_pointer(copied.arena_pointer),
+      note_chord_pointer(copied.note_chord_pointer) {
   copy_children(copied);
 }
 
@@ -67,12 +92,14 @@ auto TreeNode::from_json(const QJsonValue &json_note_chord) -> void {
     qCritical("Expected array!");
   }
   auto json_array = json_children.toArray();
+  child_pointers.reserve(json_array.size());
   for (auto index = 0; index < json_array.size(); index = index + 1) {
     // will error if childless
-    auto child_pointer = std::make_unique<TreeNode>(this);
+    auto child_pointer = new_child();
     child_pointer->from_json(json_array.at(index));
     child_pointers.push_back(std::move(child_pointer));
   }
+  renumber_children(0);
 }
 
 void TreeNode::error_not_a_child() { qCritical("Not a child!"); };
@@ -86,13 +113,19 @@ auto TreeNode::is_at_row() const -> int {
     return 0;
   }
   auto &siblings = parent_pointer->child_pointers;
-  for (auto index = 0; index < siblings.size(); index = index + 1) {
-    if (this == siblings[index].get()) {
-      return index;
-    }
+  if (row < 0 || row >= siblings.size() || siblings[row].get() != this) {
+    error_not_a_child();
+    return -1;
+  }
+  return row;
+}
+
+// rows before first_position didn't move
+void TreeNode::renumber_children(int first_position) {
+  for (auto index = first_position; index < child_pointers.size();
+       index = index + 1) {
+    child_pointers[index]->row = index;
   }
-  error_not_a_child();
-  return -1;
 }
 
 auto TreeNode::error_is_root() -> void { qCritical("Is root"); }
@@ -158,6 +191,7 @@ auto TreeNode::removeRows(int position, size_t rows) -> void {
   check_child_at(position + rows - 1);
   child_pointers.erase(child_pointers.begin() + position,
                        child_pointers.begin() + position + static_cast<int>(rows));
+  renumber_children(position);
 }
 
 // use additional deleted_rows to save deleted rows
@@ -173,51 +207,59 @@ auto TreeNode::removeRows(int position, size_t rows,
   removeRows(position, rows);
 }
 
-auto TreeNode::setData(int column, const QVariant &value, int role) const
-    -> bool {
+// copy on write, so copies sharing the data don't change
+auto TreeNode::setData(int column, const QVariant &value, int role) -> bool {
   if (note_chord_pointer == nullptr) {
     TreeNode::error_is_root();
   }
+  if (note_chord_pointer.use_count() > 1) {
+    note_chord_pointer = note_chord_pointer->pointer_copy_self(arena_pointer);
+  }
   return note_chord_pointer->setData(column, value, role);
 }
 
+// build the new children first, so we only shift the old ones once
+// the vector overload checks the position
 auto TreeNode::insertRows(int position, const QJsonArray &json_array) -> void {
-  check_insertable_at(position);
-  for (qsizetype row = 0; row < json_array.size(); row = row + 1) {
+  std::vector<std::unique_ptr<TreeNode>> insertion;
+  insertion.reserve(json_array.size());
+  for (const auto &json_child : json_array) {
     // will error if childless
-    auto child_pointer = std::make_unique<TreeNode>(this);
+    auto child_pointer = new_child();
     // will error if level mismatch
-    child_pointer->from_json(json_array[row].toObject());
-    child_pointers.insert(child_pointers.begin() + position + row,
-                          std::move(child_pointer));
+    child_pointer->from_json(json_child.toObject());
+    insertion.push_back(std::move(child_pointer));
   }
+  insertRows(position, insertion);
 };
 
 auto TreeNode::insertRows(int position,
                           std::vector<std::unique_ptr<TreeNode>> &insertion)
     -> void {
+  check_insertable_at(position);
   auto child_level = get_level() + 1;
   // make sure we are inserting the right level items
-  for (const auto &child_pointer : child_pointers) {
+  for (const auto &child_pointer : insertion) {
     auto new_child_level = child_pointer->get_level();
     if (child_level != new_child_level) {
       qCritical("Level mismatch between level %d and new level %d!", child_level, new_child_level);
     }
   }
-  check_insertable_at(position);
   child_pointers.insert(child_pointers.begin() + position,
                         std::make_move_iterator(insertion.begin()),
                         std::make_move_iterator(insertion.end()));
   insertion.clear();
+  renumber_children(position);
 };
 
 auto TreeNode::insertRows(int position, int rows) -> void {
-  check_insertable_at(position);
+  std::vector<std::unique_ptr<TreeNode>> insertion;
+  insertion.reserve(rows);
   for (int row = 0; row < rows; row = row + 1) {
     // will error if childless
-    child_pointers.insert(child_pointers.begin() + position + row,
-                          std::make_unique<TreeNode>(this));
+    insertion.push_back(new_child());
   }
+  insertRows(position, insertion);
 };
 
 // TODO: translate
@@ -230,7 +272,8 @@ auto TreeNode::copy(int position, size_t rows, std::vector<std::unique_ptr<TreeN
   // the size of this int needs to match position
   copied.clear();
   for (int index = 0; index < rows; index = index + 1) {
-    copied.push_back(std::make_unique<TreeNode>(*(child_pointers[position + index])));
+    copied.push_back(std::unique_ptr<TreeNode>(
+        new (arena_pointer) TreeNode(*(child_pointers[position + index]))));
   }
 }
 
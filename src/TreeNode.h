@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Chord.h"
+#include "NodeArena.h"
 #include <QJsonArray>
 
 const auto ROOT_LEVEL = 0;
@@ -9,28 +10,43 @@ class TreeNode {
  public:
   // pointer so it can be null for root
   TreeNode *const parent_pointer = nullptr;
+  // the song's, shared by the whole tree, or null for the general heap
+  NodeArena *const arena_pointer = nullptr;
   // pointer so it can be a note or a chord
-  const std::unique_ptr<NoteChord> note_chord_pointer;
+  // shared with copies, like the clipboard, until one of them is edited
+  std::shared_ptr<NoteChord> note_chord_pointer;
   // pointers so they can be notes or chords
   std::vector<std::unique_ptr<TreeNode>> child_pointers;
+  // where we are among our siblings, so finding it doesn't need a search
+  // renumbered whenever children are inserted or removed
+  int row = 0;
   
-  explicit TreeNode(TreeNode *parent_pointer_input = nullptr);
+  // children use their parent's arena
+  explicit TreeNode(TreeNode *parent_pointer_input = nullptr,
+                    NodeArena *arena_pointer_input = nullptr);
+
+  static auto operator new(size_t size) -> void *;
+  static auto operator new(size_t size, NodeArena *arena_pointer) -> void *;
+  static void operator delete(void *pointer);
+  static void operator delete(void *pointer, NodeArena *arena_pointer);
+
   TreeNode(TreeNode& copied, TreeNode *parent_pointer_input);
   TreeNode(TreeNode& copied);
   void copy_children(TreeNode& copied);
 
-  auto new_child_note_chord_pointer(TreeNode *parent_pointer) -> std::unique_ptr<NoteChord>;
-  auto new_child_note_chord_pointer() -> std::unique_ptr<NoteChord>;
-  auto copy_note_chord_pointer() const -> std::unique_ptr<NoteChord>;
+  auto new_child_note_chord_pointer(TreeNode *parent_pointer) -> std::shared_ptr<NoteChord>;
+  auto new_child_note_chord_pointer() const -> std::shared_ptr<NoteChord>;
+  [[nodiscard]] auto new_child() -> std::unique_ptr<TreeNode>;
   static void error_level(int level);
   static void error_row(size_t row);
   static void error_not_a_child();
   static void error_is_root();
   [[nodiscard]] auto is_at_row() const -> int;
+  void renumber_children(int first_position);
   auto check_child_at(size_t position) const -> void;
   auto check_insertable_at(int position) const -> void;
   [[nodiscard]] auto data(int column, int role) const -> QVariant;
-  [[nodiscard]] auto setData(int column, const QVariant &value, int role) const
+  [[nodiscard]] auto setData(int column, const QVariant &value, int role)
       -> bool;
   auto insertRows(int position, int rows) -> void;
   auto insertRows(int position, const QJsonArray &json_array) -> void;
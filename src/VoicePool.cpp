@@ -0,0 +1,81 @@
+#include "VoicePool.h"
+
+// add the voice to the mono bus
+// scratch is separate, so voices can render on different threads
+void Voice::render(float *bus_pointer, float *scratch_pointer, int frames) {
+  auto sounding_frames = frames - delay_frames;
+  instrument_pointer->render(scratch_pointer, sounding_frames);
+  for (auto frame = 0; frame < sounding_frames; frame = frame + 1) {
+    bus_pointer[delay_frames + frame] += scratch_pointer[frame];
+  }
+  delay_frames = 0;
+  if (instrument_pointer->done()) {
+    active = false;
+  }
+}
+
+VoicePool::VoicePool(const Instrument &prototype, int max_polyphony,
+                     StealingPolicy stealing_policy_input)
+    : prototype_pointer(prototype.new_voice_pointer()),
+      stealing_policy(stealing_policy_input) {
+  resize(max_polyphony);
+}
+
+// allocates, so only call this while stopped
+void VoicePool::resize(int max_polyphony) {
+  if (max_polyphony < 1) {
+    qCritical("Need at least 1 voice, not %d!", max_polyphony);
+    max_polyphony = 1;
+  }
+  voices.clear();
+  voices.resize(max_polyphony);
+  for (auto &voice : voices) {
+    voice.instrument_pointer = prototype_pointer->new_voice_pointer();
+  }
+}
+
+auto VoicePool::get_voice() -> Voice & {
+  for (auto &voice : voices) {
+    if (!voice.active) {
+      return voice;
+    }
+  }
+  // every voice is busy, so pick one to steal
+  auto *chosen_pointer = &voices[0];
+  for (auto &voice : voices) {
+    if (stealing_policy == steal_oldest) {
+      if (voice.start_frame < chosen_pointer->start_frame) {
+        chosen_pointer = &voice;
+      }
+    } else if (voice.instrument_pointer->get_level() <
+               chosen_pointer->instrument_pointer->get_level()) {
+      chosen_pointer = &voice;
+    }
+  }
+  return *chosen_pointer;
+}
+
+void VoicePool::start_voice(int64_t start_frame, int delay_frames,
+                            float frequency, float amplitude, float duration) {
+  auto &voice = get_voice();
+  voice.instrument_pointer->start(frequency, amplitude, duration);
+  voice.active = true;
+  voice.start_frame = start_frame;
+  voice.delay_frames = delay_frames;
+}
+
+void VoicePool::clear() {
+  for (auto &voice : voices) {
+    voice.active = false;
+  }
+}
+
+auto VoicePool::get_active_count() const -> int {
+  auto active_count = 0;
+  for (const auto &voice : voices) {
+    if (voice.active) {
+      active_count = active_count + 1;
+    }
+  }
+  return active_count;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include "Instrument.h"
+
+const auto DEFAULT_MAX_POLYPHONY = 64;
+
+enum StealingPolicy {
+  steal_oldest,
+  steal_quietest,
+};
+
+class Voice {
+ public:
+  std::unique_ptr<Instrument> instrument_pointer;
+  bool active = false;
+  int64_t start_frame = 0;
+  // frames to wait, within the current block, before sounding
+  int delay_frames = 0;
+
+  void render(float *bus_pointer, float *scratch_pointer, int frames);
+};
+
+// all voices for one instrument, allocated up front
+// when every voice is busy, we steal one instead of allocating
+class VoicePool {
+ public:
+  const std::unique_ptr<Instrument> prototype_pointer;
+  StealingPolicy stealing_policy;
+  std::vector<Voice> voices;
+  // only the audio thread uses this
+  bool muted = false;
+
+  VoicePool(const Instrument &prototype, int max_polyphony,
+            StealingPolicy stealing_policy_input);
+
+  void resize(int max_polyphony);
+  [[nodiscard]] auto get_voice() -> Voice &;
+  void start_voice(int64_t start_frame, int delay_frames, float frequency,
+                   float amplitude, float duration);
+  void clear();
+  [[nodiscard]] auto get_active_count() const -> int;
+};
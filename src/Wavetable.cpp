@@ -0,0 +1,69 @@
+#include "Wavetable.h"
+
+#include <numbers>
+
+WavetableBank::WavetableBank() {
+  // scale like the DSF, by the sum of all harmonic amplitudes
+  auto total_amplitude = 0.0;
+  auto harmonic_amplitude = 1.0;
+  for (auto harmonic = 0; harmonic < HARMONICS; harmonic = harmonic + 1) {
+    total_amplitude = total_amplitude + harmonic_amplitude;
+    harmonic_amplitude = harmonic_amplitude * AMPLITUDE_RATIO;
+  }
+  // each table adds one more harmonic to the one before
+  std::array<double, WAVETABLE_SIZE + 1> sums{};
+  harmonic_amplitude = 1.0 / total_amplitude;
+  for (auto harmonic = 0; harmonic < HARMONICS; harmonic = harmonic + 1) {
+    auto harmonic_ratio = 1.0 + harmonic * FREQUENCY_RATIO;
+    auto &table = tables[harmonic];
+    for (auto point = 0; point <= WAVETABLE_SIZE; point = point + 1) {
+      sums[point] = sums[point] +
+                    harmonic_amplitude *
+                        sin(2 * std::numbers::pi * harmonic_ratio * point /
+                            WAVETABLE_SIZE);
+      table[point] = static_cast<float>(sums[point]);
+    }
+    harmonic_amplitude = harmonic_amplitude * AMPLITUDE_RATIO;
+  }
+}
+
+auto WavetableBank::get_bank() -> const WavetableBank & {
+  static const WavetableBank bank;
+  return bank;
+}
+
+// the richest table with no harmonics above nyquist
+auto WavetableBank::get_table(float frequency, double frames_per_second) const
+    -> const float * {
+  auto harmonics = 1;
+  if (frequency > 0) {
+    auto highest_harmonic =
+        static_cast<int>((frames_per_second / 2 / frequency - 1) / FREQUENCY_RATIO) + 1;
+    harmonics = std::clamp(highest_harmonic, 1, HARMONICS);
+  }
+  return tables[harmonics - 1].data();
+}
+
+auto WavetableBank::get_phase_increment(float frequency,
+                                        double frames_per_second) -> uint32_t {
+  return static_cast<uint32_t>(
+      std::llround(frequency / frames_per_second * PHASE_RANGE));
+}
+
+// linear interpolation, no branches, so the loop can vectorize
+void WavetableBank::render(const float *table_pointer, uint32_t &phase,
+                           uint32_t phase_increment, float *destination,
+                           int frames) {
+  auto current_phase = phase;
+  for (auto frame = 0; frame < frames; frame = frame + 1) {
+    auto point = current_phase >> PHASE_FRACTION_BITS;
+    auto fraction = static_cast<float>(current_phase & PHASE_FRACTION_MASK) /
+                    (1U << PHASE_FRACTION_BITS);
+    auto left_value = table_pointer[point];
+    destination[frame] =
+        left_value + (table_pointer[point + 1] - left_value) * fraction;
+    // wraps around at the end of the table
+    current_phase = current_phase + phase_increment;
+  }
+  phase = current_phase;
+}
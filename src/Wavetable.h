@@ -0,0 +1,30 @@
+#pragma once
+
+#include "DefaultInstrument.h"
+
+// must be a power of 2, so the phase wraps for free
+const auto WAVETABLE_BITS = 11;
+const auto WAVETABLE_SIZE = 1 << WAVETABLE_BITS;
+// the rest of a 32 bit phase is the fraction between points
+const auto PHASE_FRACTION_BITS = 32 - WAVETABLE_BITS;
+const auto PHASE_FRACTION_MASK = (1U << PHASE_FRACTION_BITS) - 1;
+const auto PHASE_RANGE = 4294967296.0;
+
+// one cycle of the default timbre, at every level of band-limiting
+// table h has only the first h + 1 harmonics, so high notes don't alias
+// shared by every voice, because the timbre never changes
+class WavetableBank {
+ public:
+  // an extra point at the end, so interpolation never wraps
+  std::array<std::array<float, WAVETABLE_SIZE + 1>, HARMONICS> tables{};
+
+  WavetableBank();
+  [[nodiscard]] static auto get_bank() -> const WavetableBank &;
+  [[nodiscard]] auto get_table(float frequency, double frames_per_second) const
+      -> const float *;
+  [[nodiscard]] static auto get_phase_increment(float frequency,
+                                                double frames_per_second)
+      -> uint32_t;
+  static void render(const float *table_pointer, uint32_t &phase,
+                     uint32_t phase_increment, float *destination, int frames);
+};
@@ -41,10 +41,12 @@ Insert::Insert(Song &song_input, int position_input, std::vector<std::unique_ptr
       position(position_input),
       rows(copied.size()),
       parent_index(parent_index_input) {
+  auto &parent_node = song.node_from_index(parent_index);
   for (int index = 0; index < copied.size(); index = index + 1) {
     // copy clipboard so we can paste multiple times
+    // copies share note and chord data, so this only copies the tree
     // reparent too
-    inserted.push_back(std::make_unique<TreeNode>(*(copied[index]), &(song.node_from_index(parent_index))));
+    inserted.push_back(std::unique_ptr<TreeNode>(new (parent_node.arena_pointer) TreeNode(*(copied[index]), &parent_node)));
   }
 };
 
@@ -0,0 +1,123 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <atomic>
+#include <cstdio>
+
+#include "Render.h"
+
+const auto DEFAULT_FRAMES_PER_SECOND = 44100;
+
+// renders the whole song, false if we couldn't read, parse, or write
+auto render_song(const QString &song_file, const QString &output_file,
+                 double frames_per_second) -> bool {
+  QFile input(song_file);
+  if (!input.open(QIODevice::ReadOnly)) {
+    qCritical("Cannot read %s!", qUtf8Printable(song_file));
+    return false;
+  }
+  QJsonParseError parse_error;
+  auto document = QJsonDocument::fromJson(input.readAll(), &parse_error);
+  input.close();
+  if (parse_error.error != QJsonParseError::NoError) {
+    qCritical("Cannot parse %s: %s!", qUtf8Printable(song_file),
+              qUtf8Printable(parse_error.errorString()));
+    return false;
+  }
+  if (!document.isObject()) {
+    qCritical("Expected object in %s!", qUtf8Printable(song_file));
+    return false;
+  }
+  Song song;
+  song.load(document.object());
+  auto chords = static_cast<int>(song.root.get_child_count());
+  // files render in parallel, so each render uses one thread
+  return render_to_file(
+      chords == 0 ? Performance() : Performance(song, song.index(0, 0), chords),
+      frames_per_second, output_file, 0);
+}
+
+auto main(int number_of_arguments, char *arguments[]) -> int {
+  QCoreApplication app(number_of_arguments, arguments);
+  QCoreApplication::setApplicationName("justly-render");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+      QObject::tr("Render Justly songs to sound files, one per core"));
+  parser.addHelpOption();
+  parser.addPositionalArgument("songs", QObject::tr("Song files (*.json)"),
+                               "songs...");
+  QCommandLineOption output_option(
+      {"o", "output"}, QObject::tr("Folder for the sound files"),
+      QObject::tr("folder"));
+  parser.addOption(output_option);
+  QCommandLineOption format_option({"f", "format"},
+                                   QObject::tr("wav or flac"),
+                                   QObject::tr("format"), "wav");
+  parser.addOption(format_option);
+  QCommandLineOption rate_option(
+      {"r", "rate"}, QObject::tr("Sample rate"), QObject::tr("frames"),
+      QString::number(DEFAULT_FRAMES_PER_SECOND));
+  parser.addOption(rate_option);
+  QCommandLineOption jobs_option(
+      {"j", "jobs"}, QObject::tr("Songs to render at once"),
+      QObject::tr("jobs"), QString::number(QThread::idealThreadCount()));
+  parser.addOption(jobs_option);
+  parser.process(app);
+
+  const auto song_files = parser.positionalArguments();
+  if (song_files.empty()) {
+    parser.showHelp(1);
+  }
+  auto frames_per_second = parser.value(rate_option).toDouble();
+  if (frames_per_second <= 0) {
+    qCritical("Invalid sample rate %s!",
+              qUtf8Printable(parser.value(rate_option)));
+    return 1;
+  }
+  auto extension = parser.value(format_option).toLower();
+  if (extension != "wav" && extension != "flac") {
+    qCritical("Invalid format %s!", qUtf8Printable(extension));
+    return 1;
+  }
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(std::max(parser.value(jobs_option).toInt(), 1));
+  std::atomic<int> failures = 0;
+  QMutex print_mutex;
+  QElapsedTimer total_clock;
+  total_clock.start();
+  for (const auto &song_file : song_files) {
+    QFileInfo song_info(song_file);
+    auto output_folder = parser.isSet(output_option)
+                             ? QDir(parser.value(output_option))
+                             : song_info.dir();
+    auto output_file =
+        output_folder.filePath(song_info.completeBaseName() + "." + extension);
+    pool.start([&, song_file, output_file]() {
+      QElapsedTimer clock;
+      clock.start();
+      auto succeeded = render_song(song_file, output_file, frames_per_second);
+      if (!succeeded) {
+        failures = failures + 1;
+      }
+      QMutexLocker locker(&print_mutex);
+      std::printf("%s: %s in %.3f s\n", qUtf8Printable(song_file),
+                  succeeded ? "rendered" : "failed",
+                  static_cast<double>(clock.elapsed()) / MILLISECONDS_PER_SECOND);
+      std::fflush(stdout);
+    });
+  }
+  pool.waitForDone();
+  std::printf("%lld songs in %.3f s\n", static_cast<long long>(song_files.size()),
+              static_cast<double>(total_clock.elapsed()) / MILLISECONDS_PER_SECOND);
+  return failures == 0 ? 0 : 1;
+}